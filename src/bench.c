@@ -0,0 +1,1457 @@
+/**
+ * Open fx-BA: TI BA II Plus Clone
+ * bench.c - Host-side microbenchmarks
+ *
+ * Inputs are drawn from a fixed-seed generator so runs are comparable
+ * across commits. Results are kept live through a volatile sink so the
+ * optimizer cannot drop the timed work.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "bench.h"
+#include "bond.h"
+#include "cashflow.h"
+#include "config.h"
+#include "date.h"
+#include "depreciation.h"
+#include "finmath.h"
+#include "input.h"
+#include "portfolio.h"
+#include "statistics.h"
+#include "tvm.h"
+#include "xcashflow.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/* ============================================================
+ * Helpers
+ * ============================================================ */
+
+static volatile double benchSink;
+
+static unsigned long benchSeed = 0x2545F491UL;
+
+static unsigned long bench_rand(void) {
+  /* xorshift32: deterministic and identical on every host */
+  benchSeed ^= (benchSeed << 13) & 0xFFFFFFFFUL;
+  benchSeed ^= benchSeed >> 17;
+  benchSeed ^= (benchSeed << 5) & 0xFFFFFFFFUL;
+  return benchSeed;
+}
+
+static int bench_rand_range(int lo, int hi) {
+  return lo + (int)(bench_rand() % (unsigned long)(hi - lo + 1));
+}
+
+static double bench_seconds(clock_t start) {
+  return (double)(clock() - start) / (double)CLOCKS_PER_SEC;
+}
+
+/* Wall time for multithreaded cases (clock() sums CPU over threads) */
+static double bench_wall_now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+void bench_print_result(const BenchResult *r) {
+  double opsPerSec = (r->seconds > 0.0) ? (double)r->ops / r->seconds : 0.0;
+  double nsPerOp =
+      (r->ops > 0) ? r->seconds * 1e9 / (double)r->ops : 0.0;
+  double itersPerOp =
+      (r->ops > 0) ? (double)r->iterations / (double)r->ops : 0.0;
+
+  if (r->iterations > 0) {
+    printf("  %-34s %12.0f ops/s  %9.1f ns/op  %6.2f it/op\n", r->name,
+           opsPerSec, nsPerOp, itersPerOp);
+  } else {
+    printf("  %-34s %12.0f ops/s  %9.1f ns/op\n", r->name, opsPerSec,
+           nsPerOp);
+  }
+
+  /* One JSON object per line; extract with: grep '^{' */
+  printf("{\"case\":\"%s\",\"ops\":%ld,\"seconds\":%.6f,"
+         "\"ns_per_op\":%.2f,\"iters_per_op\":",
+         r->name, r->ops, r->seconds, nsPerOp);
+  if (r->iterations > 0)
+    printf("%.3f}\n", itersPerOp);
+  else
+    printf("null}\n");
+}
+
+/* ============================================================
+ * Date Conversions
+ * ============================================================ */
+
+#define BENCH_DATE_COUNT 4096
+#define BENCH_DATE_ROUNDS 512
+
+/*
+ * Reference copy of the former year-by-year / month-by-month conversion,
+ * kept here only so the speedup stays measurable.
+ */
+static long legacy_days_from_civil(int year, int month, int day) {
+  static const int days[] = {0, 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+  long total = 0;
+
+  for (int y = 1900; y < year; y++) {
+    total += date_is_leap_year(y) ? 366 : 365;
+  }
+  for (int m = 1; m < month; m++) {
+    total += (m == 2 && date_is_leap_year(year)) ? 29 : days[m];
+  }
+
+  return total + day;
+}
+
+void bench_run_dates(void) {
+  static Date dates[BENCH_DATE_COUNT];
+  static long dayNumbers[BENCH_DATE_COUNT];
+
+  for (int i = 0; i < BENCH_DATE_COUNT; i++) {
+    dates[i].year = bench_rand_range(1900, 2099);
+    dates[i].month = bench_rand_range(1, 12);
+    dates[i].day =
+        bench_rand_range(1, date_days_in_month(dates[i].month, dates[i].year));
+    dayNumbers[i] = date_to_days_since_epoch(&dates[i]);
+  }
+
+  long ops = (long)BENCH_DATE_COUNT * BENCH_DATE_ROUNDS;
+  BenchResult r;
+  clock_t start;
+  long acc;
+
+  /* Before: loop over years and months */
+  acc = 0;
+  start = clock();
+  for (int round = 0; round < BENCH_DATE_ROUNDS; round++) {
+    for (int i = 0; i < BENCH_DATE_COUNT; i++) {
+      acc += legacy_days_from_civil(dates[i].year, dates[i].month,
+                                    dates[i].day);
+    }
+  }
+  r.name = "days_from_civil (legacy loop)";
+  r.ops = ops;
+  r.iterations = 0;
+  r.seconds = bench_seconds(start);
+  benchSink = (double)acc;
+  bench_print_result(&r);
+
+  /* After: closed-form arithmetic */
+  acc = 0;
+  start = clock();
+  for (int round = 0; round < BENCH_DATE_ROUNDS; round++) {
+    for (int i = 0; i < BENCH_DATE_COUNT; i++) {
+      acc += date_days_from_civil(dates[i].year, dates[i].month, dates[i].day);
+    }
+  }
+  r.name = "days_from_civil (O(1))";
+  r.ops = ops;
+  r.iterations = 0;
+  r.seconds = bench_seconds(start);
+  benchSink = (double)acc;
+  bench_print_result(&r);
+
+  /* Inverse direction */
+  acc = 0;
+  start = clock();
+  for (int round = 0; round < BENCH_DATE_ROUNDS; round++) {
+    for (int i = 0; i < BENCH_DATE_COUNT; i++) {
+      Date d;
+      date_civil_from_days(dayNumbers[i], &d);
+      acc += d.day;
+    }
+  }
+  r.name = "civil_from_days (O(1))";
+  r.ops = ops;
+  r.iterations = 0;
+  r.seconds = bench_seconds(start);
+  benchSink = (double)acc;
+  bench_print_result(&r);
+
+  /* Bond path: YYYYMMDD -> day number */
+  acc = 0;
+  start = clock();
+  for (int round = 0; round < BENCH_DATE_ROUNDS; round++) {
+    for (int i = 0; i < BENCH_DATE_COUNT; i++) {
+      acc += date_to_days(dates[i].year * 10000 + dates[i].month * 100 +
+                          dates[i].day);
+    }
+  }
+  r.name = "date_to_days (bond, YYYYMMDD)";
+  r.ops = ops;
+  r.iterations = 0;
+  r.seconds = bench_seconds(start);
+  benchSink = (double)acc;
+  bench_print_result(&r);
+}
+
+/* ============================================================
+ * TVM Interest Rate Solve
+ * ============================================================ */
+
+#define BENCH_IY_COUNT 4096
+#define BENCH_IY_ROUNDS 8
+
+void bench_run_tvm_iy(void) {
+  static double n[BENCH_IY_COUNT], pv[BENCH_IY_COUNT];
+  static double pmt[BENCH_IY_COUNT], fv[BENCH_IY_COUNT];
+  static TVMMode mode[BENCH_IY_COUNT];
+
+  /* Loans, annuities and balloon notes priced off a known rate */
+  for (int i = 0; i < BENCH_IY_COUNT; i++) {
+    double rate = (0.25 + bench_rand_range(0, 1200) / 100.0) / 1200.0;
+    n[i] = (double)bench_rand_range(12, 480);
+    pv[i] = 1000.0 * bench_rand_range(10, 900);
+    fv[i] = (bench_rand() % 4 == 0) ? -pv[i] * 0.3 : 0.0;
+    mode[i] = (bench_rand() % 5 == 0) ? TVM_BEGIN : TVM_END;
+    pmt[i] = tvm_calc_pmt(n[i], rate, pv[i], fv[i], mode[i]);
+  }
+
+  long ops = (long)BENCH_IY_COUNT * BENCH_IY_ROUNDS;
+  long evaluations = 0;
+  BenchResult r;
+  clock_t start = clock();
+  double acc = 0.0;
+
+  for (int round = 0; round < BENCH_IY_ROUNDS; round++) {
+    for (int i = 0; i < BENCH_IY_COUNT; i++) {
+      int err, iterations;
+      acc += tvm_calc_iy_from(n[i], pv[i], pmt[i], fv[i], mode[i], -1.0,
+                              &iterations, &err);
+      evaluations += iterations;
+    }
+  }
+  r.name = "tvm_calc_iy";
+  r.ops = ops;
+  r.iterations = evaluations;
+  r.seconds = bench_seconds(start);
+  benchSink = acc;
+  bench_print_result(&r);
+}
+
+/* ============================================================
+ * Batch TVM (loan tape)
+ * ============================================================ */
+
+#define BENCH_TAPE_COUNT 16384
+#define BENCH_TAPE_ROUNDS 32
+
+void bench_run_tvm_batch(void) {
+  static double n[BENCH_TAPE_COUNT], iy[BENCH_TAPE_COUNT];
+  static double pv[BENCH_TAPE_COUNT], pmt[BENCH_TAPE_COUNT];
+  static double fv[BENCH_TAPE_COUNT], py[BENCH_TAPE_COUNT];
+  static double cy[BENCH_TAPE_COUNT], out[BENCH_TAPE_COUNT];
+  static TVMMode mode[BENCH_TAPE_COUNT];
+  static int err[BENCH_TAPE_COUNT];
+
+  /* Mortgage-like tape: 10-30 year terms, 2-9% rates, monthly */
+  for (int i = 0; i < BENCH_TAPE_COUNT; i++) {
+    n[i] = 12.0 * bench_rand_range(10, 30);
+    iy[i] = 2.0 + bench_rand_range(0, 700) / 100.0;
+    pv[i] = 1000.0 * bench_rand_range(50, 900);
+    pmt[i] = 0.0;
+    fv[i] = 0.0;
+    py[i] = 12.0;
+    cy[i] = 12.0;
+    mode[i] = TVM_END;
+  }
+
+  long ops = (long)BENCH_TAPE_COUNT * BENCH_TAPE_ROUNDS;
+  BenchResult r;
+  clock_t start;
+  double acc;
+
+  /* Before: one Calculator per loan */
+  acc = 0.0;
+  start = clock();
+  for (int round = 0; round < BENCH_TAPE_ROUNDS; round++) {
+    for (int i = 0; i < BENCH_TAPE_COUNT; i++) {
+      Calculator calc;
+      calc_init(&calc, MODEL_STANDARD);
+      calc.tvm.N = n[i];
+      calc.tvm.I_Y = iy[i];
+      calc.tvm.PV = pv[i];
+      calc.tvm.FV = fv[i];
+      calc.tvm.P_Y = py[i];
+      calc.tvm.C_Y = cy[i];
+      calc.tvm.mode = mode[i];
+      acc += tvm_solve_for(&calc, TVM_VAR_PMT);
+    }
+  }
+  r.name = "PMT via tvm_solve_for (per loan)";
+  r.ops = ops;
+  r.iterations = 0;
+  r.seconds = bench_seconds(start);
+  benchSink = acc;
+  bench_print_result(&r);
+
+  /* After: structure-of-arrays batch */
+  acc = 0.0;
+  start = clock();
+  for (int round = 0; round < BENCH_TAPE_ROUNDS; round++) {
+    tvm_solve_batch(TVM_VAR_PMT, n, iy, pv, pmt, fv, py, cy, mode, out, err,
+                    BENCH_TAPE_COUNT);
+    acc += out[round];
+  }
+  r.name = "PMT via tvm_solve_batch (SoA)";
+  r.ops = ops;
+  r.iterations = 0;
+  r.seconds = bench_seconds(start);
+  benchSink = acc;
+  bench_print_result(&r);
+}
+
+/* ============================================================
+ * Amortization Schedules
+ * ============================================================ */
+
+#define BENCH_AMORT_LOANS 2048
+#define BENCH_AMORT_ROWS 360
+
+static int bench_amort_sink(void *context, int period,
+                            const AmortResult *row) {
+  (void)period;
+  *(double *)context += row->interest;
+  return 0;
+}
+
+void bench_run_amort(void) {
+  static double rate[BENCH_AMORT_LOANS], pv[BENCH_AMORT_LOANS];
+  static double pmt[BENCH_AMORT_LOANS];
+  static AmortResult rows[BENCH_AMORT_ROWS];
+
+  for (int i = 0; i < BENCH_AMORT_LOANS; i++) {
+    rate[i] = (2.0 + bench_rand_range(0, 700) / 100.0) / 1200.0;
+    pv[i] = 1000.0 * bench_rand_range(50, 900);
+    pmt[i] = -pv[i] * rate[i] / (1.0 - pow(1.0 + rate[i], -BENCH_AMORT_ROWS));
+  }
+
+  long ops = (long)BENCH_AMORT_LOANS * BENCH_AMORT_ROWS;
+  BenchResult r;
+  clock_t start;
+  double acc;
+
+  /* Before: closed form (one pow) per row */
+  acc = 0.0;
+  start = clock();
+  for (int i = 0; i < BENCH_AMORT_LOANS; i++) {
+    for (int p = 1; p <= BENCH_AMORT_ROWS; p++)
+      acc += tvm_amort_period(p, BENCH_AMORT_ROWS, rate[i], pv[i], pmt[i])
+                 .interest;
+  }
+  r.name = "amort rows via tvm_amort_period";
+  r.ops = ops;
+  r.iterations = 0;
+  r.seconds = bench_seconds(start);
+  benchSink = acc;
+  bench_print_result(&r);
+
+  /* After: recurrence into a row buffer */
+  acc = 0.0;
+  start = clock();
+  for (int i = 0; i < BENCH_AMORT_LOANS; i++) {
+    tvm_amort_schedule(1, BENCH_AMORT_ROWS, rate[i], pv[i], pmt[i], rows,
+                       BENCH_AMORT_ROWS, NULL, NULL);
+    acc += rows[BENCH_AMORT_ROWS - 1].balance;
+  }
+  r.name = "amort rows via tvm_amort_schedule";
+  r.ops = ops;
+  r.iterations = 0;
+  r.seconds = bench_seconds(start);
+  benchSink = acc;
+  bench_print_result(&r);
+
+  /* Streaming: sink only, nothing stored */
+  acc = 0.0;
+  start = clock();
+  for (int i = 0; i < BENCH_AMORT_LOANS; i++)
+    tvm_amort_schedule(1, BENCH_AMORT_ROWS, rate[i], pv[i], pmt[i], NULL, 0,
+                       bench_amort_sink, &acc);
+  r.name = "amort rows streamed to a sink";
+  r.ops = ops;
+  r.iterations = 0;
+  r.seconds = bench_seconds(start);
+  benchSink = acc;
+  bench_print_result(&r);
+}
+
+/* ============================================================
+ * Cash Flows (NPV / IRR / MIRR)
+ * ============================================================ */
+
+#define BENCH_CF_COUNT 1024
+#define BENCH_CF_ROUNDS 64
+
+/* Capital project: outlay, then 2-12 flow groups of 1-24 periods */
+static void bench_random_project(CashFlowList *cf) {
+  cf_init(cf);
+  cf_set_cf0(cf, -1000.0 * bench_rand_range(50, 500));
+
+  int groups = bench_rand_range(2, 12);
+  for (int g = 0; g < groups; g++) {
+    double amount = 100.0 * bench_rand_range(-20, 120);
+    cf_add(cf, amount, bench_rand_range(1, 24));
+  }
+}
+
+#define BENCH_SERIES_GROUPS 4096 /* Monthly groups of a long project */
+#define BENCH_SERIES_ROUNDS 256
+
+/* Project-finance model far beyond MAX_CASH_FLOWS, in a heap arena */
+static void bench_run_cashflow_series(void) {
+  size_t size = (size_t)BENCH_SERIES_GROUPS * 16 + 4096;
+  void *buffer = malloc(size);
+  CashFlowArena arena;
+  CashFlowSeries series;
+
+  if (!buffer) {
+    printf("  (skipped: out of memory)\n");
+    return;
+  }
+
+  cf_arena_init(&arena, buffer, size);
+  if (!cf_series_init(&series, &arena, BENCH_SERIES_GROUPS)) {
+    free(buffer);
+    return;
+  }
+
+  series.CF0 = -2.0e7;
+  for (int g = 0; g < BENCH_SERIES_GROUPS; g++)
+    cf_series_add(&series, 100.0 * bench_rand_range(-50, 150),
+                  bench_rand_range(1, 3));
+
+  BenchResult r;
+  clock_t start = clock();
+  double acc = 0.0;
+  for (int round = 0; round < BENCH_SERIES_ROUNDS; round++)
+    acc += cf_series_npv(&series, 0.004 + round * 1e-5);
+  r.name = "cf_series_npv_4096";
+  r.ops = BENCH_SERIES_ROUNDS;
+  r.iterations = 0;
+  r.seconds = bench_seconds(start);
+  benchSink = acc;
+  bench_print_result(&r);
+
+  long evaluations = 0;
+  acc = 0.0;
+  start = clock();
+  for (int round = 0; round < BENCH_SERIES_ROUNDS; round++) {
+    int err, iterations;
+    acc += cf_series_irr(&series, 0.01, &iterations, &err);
+    evaluations += iterations;
+  }
+  r.name = "cf_series_irr_4096";
+  r.ops = BENCH_SERIES_ROUNDS;
+  r.iterations = evaluations;
+  r.seconds = bench_seconds(start);
+  benchSink = acc;
+  bench_print_result(&r);
+
+  free(buffer);
+}
+
+/*
+ * The same projects as dated flows: one per period, a month apart on a
+ * random day, so xcf_irr can be set against cf_irr above.
+ */
+static void bench_run_xcashflow(const CashFlowList projects[]) {
+  int total = 0;
+  for (int i = 0; i < BENCH_CF_COUNT; i++) {
+    total++;
+    for (int g = 0; g < projects[i].count; g++)
+      total += projects[i].frequency[g];
+  }
+
+  int *dates = malloc((size_t)total * sizeof(int));
+  double *amounts = malloc((size_t)total * sizeof(double));
+  double *years = malloc((size_t)total * sizeof(double));
+  DatedCashFlows *sets = malloc(BENCH_CF_COUNT * sizeof(DatedCashFlows));
+
+  if (!dates || !amounts || !years || !sets) {
+    printf("  (skipped: out of memory)\n");
+    free(dates);
+    free(amounts);
+    free(years);
+    free(sets);
+    return;
+  }
+
+  int used = 0;
+  for (int i = 0; i < BENCH_CF_COUNT; i++) {
+    const CashFlowList *cf = &projects[i];
+    int start = used, month = 0;
+
+    dates[used] = 20200115;
+    amounts[used++] = cf->CF0;
+    for (int g = 0; g < cf->count; g++) {
+      for (int f = 0; f < cf->frequency[g]; f++) {
+        month++;
+        dates[used] = (2020 + month / 12) * 10000 + (month % 12 + 1) * 100 +
+                      bench_rand_range(1, 28);
+        amounts[used++] = cf->amount[g];
+      }
+    }
+    xcf_load(&sets[i], &dates[start], &amounts[start], &years[start],
+             used - start, DAY_COUNT_ACT_365);
+  }
+
+  long ops = (long)BENCH_CF_COUNT * BENCH_CF_ROUNDS;
+  BenchResult r;
+  clock_t begin;
+  double acc;
+
+  acc = 0.0;
+  begin = clock();
+  for (int round = 0; round < BENCH_CF_ROUNDS; round++) {
+    for (int i = 0; i < BENCH_CF_COUNT; i++)
+      acc += xcf_npv(&sets[i], 0.08 + round * 1e-4);
+  }
+  r.name = "xcf_npv";
+  r.ops = ops;
+  r.iterations = 0;
+  r.seconds = bench_seconds(begin);
+  benchSink = acc;
+  bench_print_result(&r);
+
+  long evaluations = 0;
+  acc = 0.0;
+  begin = clock();
+  for (int round = 0; round < BENCH_CF_ROUNDS; round++) {
+    for (int i = 0; i < BENCH_CF_COUNT; i++) {
+      int err, iterations;
+      acc += xcf_irr(&sets[i], INITIAL_GUESS, &iterations, &err);
+      evaluations += iterations;
+    }
+  }
+  r.name = "xcf_irr";
+  r.ops = ops;
+  r.iterations = evaluations;
+  r.seconds = bench_seconds(begin);
+  benchSink = acc;
+  bench_print_result(&r);
+
+  /* As cf_edit_irr: nudge one flow, re-solve from the set's last root */
+  static double lastRoot[BENCH_CF_COUNT];
+  for (int i = 0; i < BENCH_CF_COUNT; i++)
+    lastRoot[i] = INITIAL_GUESS;
+
+  evaluations = 0;
+  acc = 0.0;
+  begin = clock();
+  for (int round = 0; round < BENCH_CF_ROUNDS; round++) {
+    for (int i = 0; i < BENCH_CF_COUNT; i++) {
+      double *flow = amounts + (sets[i].amount - amounts);
+      int err, iterations;
+      flow[1 + round % (sets[i].count - 1)] -= 100.0;
+      double root = xcf_irr(&sets[i], lastRoot[i], &iterations, &err);
+      if (err == ERR_NONE)
+        lastRoot[i] = root;
+      acc += root;
+      evaluations += iterations;
+    }
+  }
+  r.name = "xcf_edit_irr";
+  r.ops = ops;
+  r.iterations = evaluations;
+  r.seconds = bench_seconds(begin);
+  benchSink = acc;
+  bench_print_result(&r);
+
+  free(dates);
+  free(amounts);
+  free(years);
+  free(sets);
+}
+
+void bench_run_cashflow(void) {
+  static CashFlowList projects[BENCH_CF_COUNT];
+  static double rates[BENCH_CF_COUNT];
+
+  for (int i = 0; i < BENCH_CF_COUNT; i++) {
+    bench_random_project(&projects[i]);
+    rates[i] = bench_rand_range(1, 150) / 1000.0;
+  }
+
+  long ops = (long)BENCH_CF_COUNT * BENCH_CF_ROUNDS;
+  BenchResult r;
+  clock_t start;
+  double acc;
+
+  acc = 0.0;
+  start = clock();
+  for (int round = 0; round < BENCH_CF_ROUNDS; round++) {
+    /* A new rate each round, so every call re-discounts in full */
+    for (int i = 0; i < BENCH_CF_COUNT; i++)
+      acc += cf_npv(&projects[i], rates[i] + round * 1e-4);
+  }
+  r.name = "cf_npv";
+  r.ops = ops;
+  r.iterations = 0;
+  r.seconds = bench_seconds(start);
+  benchSink = acc;
+  bench_print_result(&r);
+
+  long evaluations = 0;
+  acc = 0.0;
+  start = clock();
+  for (int round = 0; round < BENCH_CF_ROUNDS; round++) {
+    for (int i = 0; i < BENCH_CF_COUNT; i++) {
+      int err, iterations;
+      acc += cf_irr_from(&projects[i], INITIAL_GUESS, &iterations, &err);
+      evaluations += iterations;
+    }
+  }
+  r.name = "cf_irr";
+  r.ops = ops;
+  r.iterations = evaluations;
+  r.seconds = bench_seconds(start);
+  benchSink = acc;
+  bench_print_result(&r);
+
+  /* The same, on only the projects with one sign change */
+  long solves = 0;
+  evaluations = 0;
+  acc = 0.0;
+  start = clock();
+  for (int round = 0; round < BENCH_CF_ROUNDS; round++) {
+    for (int i = 0; i < BENCH_CF_COUNT; i++) {
+      if (cf_sign_changes(&projects[i]) != 1)
+        continue;
+      int err, iterations;
+      acc += cf_irr_from(&projects[i], INITIAL_GUESS, &iterations, &err);
+      evaluations += iterations;
+      solves++;
+    }
+  }
+  r.name = "cf_irr conventional";
+  r.ops = solves;
+  r.iterations = evaluations;
+  r.seconds = bench_seconds(start);
+  benchSink = acc;
+  bench_print_result(&r);
+
+  acc = 0.0;
+  start = clock();
+  for (int round = 0; round < BENCH_CF_ROUNDS; round++) {
+    for (int i = 0; i < BENCH_CF_COUNT; i++) {
+      int err;
+      acc += cf_mirr(&projects[i], rates[i], rates[i] * 0.5, &err);
+    }
+  }
+  r.name = "cf_mirr";
+  r.ops = ops;
+  r.iterations = 0;
+  r.seconds = bench_seconds(start);
+  benchSink = acc;
+  bench_print_result(&r);
+
+  acc = 0.0;
+  start = clock();
+  for (int round = 0; round < BENCH_CF_ROUNDS; round++) {
+    for (int i = 0; i < BENCH_CF_COUNT; i++)
+      acc += cf_nfv(&projects[i], rates[i]);
+  }
+  r.name = "cf_nfv";
+  r.ops = ops;
+  r.iterations = 0;
+  r.seconds = bench_seconds(start);
+  benchSink = acc;
+  bench_print_result(&r);
+
+  acc = 0.0;
+  start = clock();
+  for (int round = 0; round < BENCH_CF_ROUNDS; round++) {
+    for (int i = 0; i < BENCH_CF_COUNT; i++)
+      acc += cf_discounted_payback(&projects[i], rates[i]);
+  }
+  r.name = "cf_discounted_payback";
+  r.ops = ops;
+  r.iterations = 0;
+  r.seconds = bench_seconds(start);
+  benchSink = acc;
+  bench_print_result(&r);
+
+  /* One upward-sloping zero curve shared by every project */
+  enum { CURVE_PERIODS = 12 * 24 };
+  static double curveBuffer[2 * CURVE_PERIODS + 64];
+  static double npvOut[BENCH_CF_COUNT];
+  const double tenors[] = {1, 12, 60, 120, 288};
+  const double zeros[] = {0.003, 0.004, 0.005, 0.0055, 0.006};
+  CashFlowArena arena;
+  DiscountCurve curve;
+  cf_arena_init(&arena, curveBuffer, sizeof(curveBuffer));
+  cf_curve_from_zeros(&curve, &arena, tenors, zeros, 5,
+                      CURVE_LOG_LINEAR_DISCOUNT, CURVE_PERIODS);
+
+  acc = 0.0;
+  start = clock();
+  for (int round = 0; round < BENCH_CF_ROUNDS; round++) {
+    cf_npv_curve_batch(projects, BENCH_CF_COUNT, &curve, npvOut, NULL);
+    acc += npvOut[round];
+  }
+  r.name = "cf_npv_curve";
+  r.ops = ops;
+  r.iterations = 0;
+  r.seconds = bench_seconds(start);
+  benchSink = acc;
+  bench_print_result(&r);
+
+  /* 200-point NPV profile per project, against 200 cf_npv calls */
+  enum { PROFILE_POINTS = 200 };
+  double profileRates[PROFILE_POINTS], profile[PROFILE_POINTS];
+  for (int k = 0; k < PROFILE_POINTS; k++)
+    profileRates[k] = 0.30 * k / PROFILE_POINTS;
+
+  acc = 0.0;
+  start = clock();
+  for (int i = 0; i < BENCH_CF_COUNT; i++) {
+    for (int k = 0; k < PROFILE_POINTS; k++)
+      acc += cf_npv(&projects[i], profileRates[k]);
+  }
+  r.name = "cf_npv_x200";
+  r.ops = BENCH_CF_COUNT;
+  r.iterations = 0;
+  r.seconds = bench_seconds(start);
+  benchSink = acc;
+  bench_print_result(&r);
+
+  acc = 0.0;
+  start = clock();
+  for (int i = 0; i < BENCH_CF_COUNT; i++) {
+    cf_npv_profile(&projects[i], profileRates, profile, PROFILE_POINTS);
+    acc += profile[PROFILE_POINTS / 2];
+  }
+  r.name = "cf_npv_profile_200";
+  r.ops = BENCH_CF_COUNT;
+  r.iterations = 0;
+  r.seconds = bench_seconds(start);
+  benchSink = acc;
+  bench_print_result(&r);
+
+  /* The same 200 rates for discounted payback */
+  acc = 0.0;
+  start = clock();
+  for (int i = 0; i < BENCH_CF_COUNT; i++) {
+    for (int k = 0; k < PROFILE_POINTS; k++)
+      acc += cf_discounted_payback(&projects[i], profileRates[k]);
+  }
+  r.name = "cf_discounted_payback_x200";
+  r.ops = BENCH_CF_COUNT;
+  r.iterations = 0;
+  r.seconds = bench_seconds(start);
+  benchSink = acc;
+  bench_print_result(&r);
+
+  acc = 0.0;
+  start = clock();
+  for (int i = 0; i < BENCH_CF_COUNT; i++) {
+    acc += cf_payback_profile(&projects[i], profileRates, profile,
+                              PROFILE_POINTS);
+    acc += profile[PROFILE_POINTS / 2];
+  }
+  r.name = "cf_payback_profile_200";
+  r.ops = BENCH_CF_COUNT;
+  r.iterations = 0;
+  r.seconds = bench_seconds(start);
+  benchSink = acc;
+  bench_print_result(&r);
+
+  /* One-flow edits: NPV at the cached rate, IRR from the last root */
+  for (int i = 0; i < BENCH_CF_COUNT; i++)
+    cf_npv(&projects[i], rates[i]);
+
+  acc = 0.0;
+  start = clock();
+  for (int round = 0; round < BENCH_CF_ROUNDS; round++) {
+    for (int i = 0; i < BENCH_CF_COUNT; i++) {
+      CashFlowList *cf = &projects[i];
+      int j = round % cf->count;
+      cf_update(cf, j, cf->amount[j] + 100.0, cf->frequency[j]);
+      acc += cf_npv(cf, rates[i]);
+    }
+  }
+  r.name = "cf_edit_npv";
+  r.ops = ops;
+  r.iterations = 0;
+  r.seconds = bench_seconds(start);
+  benchSink = acc;
+  bench_print_result(&r);
+
+  evaluations = 0;
+  acc = 0.0;
+  start = clock();
+  for (int round = 0; round < BENCH_CF_ROUNDS; round++) {
+    for (int i = 0; i < BENCH_CF_COUNT; i++) {
+      CashFlowList *cf = &projects[i];
+      int j = round % cf->count;
+      double guess = cf->cache.hasIrr ? cf->cache.irr : INITIAL_GUESS;
+      int err, iterations;
+      cf_update(cf, j, cf->amount[j] - 100.0, cf->frequency[j]);
+      acc += cf_irr_from(cf, guess, &iterations, &err);
+      evaluations += iterations;
+    }
+  }
+  r.name = "cf_edit_irr";
+  r.ops = ops;
+  r.iterations = evaluations;
+  r.seconds = bench_seconds(start);
+  benchSink = acc;
+  bench_print_result(&r);
+
+  /* Before the closing costs below, so xcf_irr sees cf_irr's projects */
+  bench_run_xcashflow(projects);
+
+  /* Non-conventional: an outlay, inflows, then a closing cost */
+  for (int i = 0; i < BENCH_CF_COUNT; i++) {
+    CashFlowList *cf = &projects[i];
+    if (cf->count < MAX_CASH_FLOWS)
+      cf_add(cf, -1000.0 * bench_rand_range(10, 400), 1);
+  }
+
+  acc = 0.0;
+  start = clock();
+  for (int round = 0; round < BENCH_CF_ROUNDS; round++) {
+    for (int i = 0; i < BENCH_CF_COUNT; i++) {
+      double roots[MAX_CASH_FLOWS];
+      int err;
+      int found = cf_irr_all(&projects[i], roots, MAX_CASH_FLOWS, &err);
+      if (found > 0)
+        acc += roots[0];
+    }
+  }
+  r.name = "cf_irr_all";
+  r.ops = ops;
+  r.iterations = 0;
+  r.seconds = bench_seconds(start);
+  benchSink = acc;
+  bench_print_result(&r);
+
+  bench_run_cashflow_series();
+}
+
+/* ============================================================
+ * Bond Yield
+ * ============================================================ */
+
+#define BENCH_BOND_COUNT 2048
+#define BENCH_BOND_ROUNDS 16
+
+void bench_run_bond_yield(void) {
+  static BondInput bonds[BENCH_BOND_COUNT];
+  static double prices[BENCH_BOND_COUNT];
+  static double yields[BENCH_BOND_COUNT];
+
+  for (int i = 0; i < BENCH_BOND_COUNT; i++) {
+    BondInput *b = &bonds[i];
+    b->settlementDate = 20240101 + bench_rand_range(0, 11) * 100;
+    b->maturityDate = (2025 + bench_rand_range(0, 29)) * 10000 + 115;
+    b->callDate = 0;
+    b->callPrice = 100.0;
+    b->couponRate = bench_rand_range(0, 32) * 0.25;
+    b->redemption = 100.0;
+    b->frequency = COUPON_SEMI_ANNUAL;
+    b->dayCount = DAY_COUNT_30_360;
+    b->bondType = BOND_TYPE_YTM;
+    yields[i] = 0.5 + bench_rand_range(0, 900) / 100.0;
+    prices[i] = bond_price(b, yields[i]);
+  }
+
+  long ops = (long)BENCH_BOND_COUNT * BENCH_BOND_ROUNDS;
+  BenchResult r;
+  clock_t start;
+  double acc;
+  long evaluations;
+
+  /* Cold start from the coupon rate */
+  acc = 0.0;
+  evaluations = 0;
+  start = clock();
+  for (int round = 0; round < BENCH_BOND_ROUNDS; round++) {
+    for (int i = 0; i < BENCH_BOND_COUNT; i++) {
+      int err, iterations;
+      acc += bond_yield_from(&bonds[i], prices[i], bonds[i].couponRate,
+                             &iterations, &err);
+      evaluations += iterations;
+    }
+  }
+  r.name = "bond_yield (cold start)";
+  r.ops = ops;
+  r.iterations = evaluations;
+  r.seconds = bench_seconds(start);
+  benchSink = acc;
+  bench_print_result(&r);
+
+  /* Warm start from a yield 10 bp away (worksheet re-solve) */
+  acc = 0.0;
+  evaluations = 0;
+  start = clock();
+  for (int round = 0; round < BENCH_BOND_ROUNDS; round++) {
+    for (int i = 0; i < BENCH_BOND_COUNT; i++) {
+      int err, iterations;
+      acc += bond_yield_from(&bonds[i], prices[i], yields[i] + 0.1,
+                             &iterations, &err);
+      evaluations += iterations;
+    }
+  }
+  r.name = "bond_yield_from (warm start)";
+  r.ops = ops;
+  r.iterations = evaluations;
+  r.seconds = bench_seconds(start);
+  benchSink = acc;
+  bench_print_result(&r);
+}
+
+/* ============================================================
+ * Bond Duration
+ * ============================================================ */
+
+#define BENCH_DURATION_COUNT 2048
+#define BENCH_DURATION_ROUNDS 64
+
+void bench_run_bond_duration(void) {
+  static BondInput bonds[BENCH_DURATION_COUNT];
+  static double yields[BENCH_DURATION_COUNT];
+
+  for (int i = 0; i < BENCH_DURATION_COUNT; i++) {
+    BondInput *b = &bonds[i];
+    b->settlementDate = 20240101 + bench_rand_range(0, 11) * 100;
+    b->maturityDate = (2025 + bench_rand_range(0, 29)) * 10000 + 115;
+    b->callDate = 0;
+    b->callPrice = 100.0;
+    b->couponRate = bench_rand_range(0, 32) * 0.25;
+    b->redemption = 100.0;
+    b->frequency = COUPON_SEMI_ANNUAL;
+    b->dayCount = DAY_COUNT_30_360;
+    b->bondType = BOND_TYPE_YTM;
+    yields[i] = 0.5 + bench_rand_range(0, 900) / 100.0;
+  }
+
+  long ops = (long)BENCH_DURATION_COUNT * BENCH_DURATION_ROUNDS;
+  BenchResult r;
+  clock_t start;
+  double acc;
+
+  acc = 0.0;
+  start = clock();
+  for (int round = 0; round < BENCH_DURATION_ROUNDS; round++) {
+    for (int i = 0; i < BENCH_DURATION_COUNT; i++)
+      acc += bond_duration(&bonds[i], yields[i]);
+  }
+  r.name = "bond_duration";
+  r.ops = ops;
+  r.iterations = 0;
+  r.seconds = bench_seconds(start);
+  benchSink = acc;
+  bench_print_result(&r);
+
+  acc = 0.0;
+  start = clock();
+  for (int round = 0; round < BENCH_DURATION_ROUNDS; round++) {
+    for (int i = 0; i < BENCH_DURATION_COUNT; i++)
+      acc += bond_risk(&bonds[i], yields[i]).convexity;
+  }
+  r.name = "bond_risk (all measures)";
+  r.ops = ops;
+  r.iterations = 0;
+  r.seconds = bench_seconds(start);
+  benchSink = acc;
+  bench_print_result(&r);
+}
+
+/* ============================================================
+ * Depreciation
+ * ============================================================ */
+
+#define BENCH_DEPR_COUNT 4096
+#define BENCH_DEPR_ROUNDS 8
+
+void bench_run_depreciation(void) {
+  static DepreciationInput assets[BENCH_DEPR_COUNT];
+  static DepreciationMethod methods[BENCH_DEPR_COUNT];
+  static int years[BENCH_DEPR_COUNT];
+
+  /* Every method, 3-40 year lives, mid-year starts, any year of life */
+  for (int i = 0; i < BENCH_DEPR_COUNT; i++) {
+    DepreciationInput *a = &assets[i];
+    a->cost = 1000.0 * bench_rand_range(5, 500);
+    a->salvage = a->cost * bench_rand_range(0, 20) / 100.0;
+    a->life = (double)bench_rand_range(3, 40);
+    a->dbRate = (bench_rand() & 1) ? 200.0 : 150.0;
+    a->startMonth = bench_rand_range(1, 12);
+    a->startYear = 2024;
+    methods[i] = (DepreciationMethod)bench_rand_range(0, DEPR_COUNT - 1);
+    years[i] = bench_rand_range(1, (int)a->life);
+  }
+
+  long ops = (long)BENCH_DEPR_COUNT * BENCH_DEPR_ROUNDS;
+  BenchResult r;
+  clock_t start = clock();
+  double acc = 0.0;
+
+  for (int round = 0; round < BENCH_DEPR_ROUNDS; round++) {
+    for (int i = 0; i < BENCH_DEPR_COUNT; i++)
+      acc += depr_calculate(&assets[i], methods[i], years[i]).depreciation;
+  }
+  r.name = "depr_calculate";
+  r.ops = ops;
+  r.iterations = 0;
+  r.seconds = bench_seconds(start);
+  benchSink = acc;
+  bench_print_result(&r);
+
+  /* Full schedules: one depr_calculate per year vs one depr_schedule */
+  DepreciationResult rows[48];
+  long rowCount = 0;
+
+  acc = 0.0;
+  start = clock();
+  for (int i = 0; i < BENCH_DEPR_COUNT; i++) {
+    int life = depr_schedule_years(&assets[i], methods[i]);
+    for (int y = 1; y <= life; y++)
+      acc += depr_calculate(&assets[i], methods[i], y).bookValueEnd;
+    rowCount += life;
+  }
+  r.name = "schedule via depr_calculate/year";
+  r.ops = rowCount;
+  r.iterations = 0;
+  r.seconds = bench_seconds(start);
+  benchSink = acc;
+  bench_print_result(&r);
+
+  acc = 0.0;
+  rowCount = 0;
+  start = clock();
+  for (int i = 0; i < BENCH_DEPR_COUNT; i++) {
+    int life = depr_schedule(&assets[i], methods[i], rows, 48);
+    if (life > 0)
+      acc += rows[life - 1].bookValueEnd;
+    rowCount += life;
+  }
+  r.name = "schedule via depr_schedule";
+  r.ops = rowCount;
+  r.iterations = 0;
+  r.seconds = bench_seconds(start);
+  benchSink = acc;
+  bench_print_result(&r);
+}
+
+/* ============================================================
+ * Statistics
+ * ============================================================ */
+
+#define BENCH_STAT_SETS 256
+#define BENCH_STAT_ROUNDS 64
+
+void bench_run_statistics(void) {
+  static StatData sets[BENCH_STAT_SETS];
+
+  /* Full worksheets of positive, noisy, roughly linear data */
+  for (int i = 0; i < BENCH_STAT_SETS; i++) {
+    stat_init(&sets[i]);
+    double slope = bench_rand_range(1, 50) / 10.0;
+    for (int k = 0; k < STAT_MAX_POINTS; k++) {
+      double x = 1.0 + k + bench_rand_range(0, 100) / 100.0;
+      double y = 10.0 + slope * x + bench_rand_range(0, 500) / 100.0;
+      stat_add_xy(&sets[i], x, y);
+    }
+  }
+
+  long ops = (long)BENCH_STAT_SETS * BENCH_STAT_ROUNDS * 4;
+  BenchResult r;
+  clock_t start = clock();
+  double acc = 0.0;
+
+  for (int round = 0; round < BENCH_STAT_ROUNDS; round++) {
+    for (int i = 0; i < BENCH_STAT_SETS; i++) {
+      for (int type = REG_LINEAR; type <= REG_POWER; type++)
+        acc += stat_regression(&sets[i], (RegressionType)type).rSq;
+    }
+  }
+  r.name = "stat_regression (50 points)";
+  r.ops = ops;
+  r.iterations = 0;
+  r.seconds = bench_seconds(start);
+  benchSink = acc;
+  bench_print_result(&r);
+}
+
+/* ============================================================
+ * Bond and Project Portfolios
+ * ============================================================ */
+
+#define BENCH_PORTFOLIO_COUNT 500000
+#define BENCH_PROJECT_COUNT 100000
+
+/* Project screen: cf_metrics for every candidate, 1..cores threads */
+static void bench_run_cashflow_portfolio(void) {
+  CashFlowList *projects = malloc(BENCH_PROJECT_COUNT * sizeof(CashFlowList));
+  CashFlowMetrics *metrics =
+      malloc(BENCH_PROJECT_COUNT * sizeof(CashFlowMetrics));
+
+  if (!projects || !metrics) {
+    printf("  (skipped: out of memory)\n");
+    free(projects);
+    free(metrics);
+    return;
+  }
+
+  for (int i = 0; i < BENCH_PROJECT_COUNT; i++)
+    bench_random_project(&projects[i]);
+
+  int cores = portfolio_default_threads();
+  printf("  %d projects\n", BENCH_PROJECT_COUNT);
+
+  double baseline = 0.0;
+  for (int threads = 1;; threads *= 2) {
+    if (threads > cores)
+      threads = cores;
+
+    double start = bench_wall_now();
+    int solved = portfolio_cashflow(projects, 0.08, 0.06, 0.10, metrics, NULL,
+                                    BENCH_PROJECT_COUNT, threads);
+    double seconds = bench_wall_now() - start;
+    double rate = (seconds > 0.0) ? BENCH_PROJECT_COUNT / seconds : 0.0;
+
+    if (threads == 1)
+      baseline = rate;
+    benchSink = metrics[BENCH_PROJECT_COUNT - 1].irr;
+
+    char name[40];
+    snprintf(name, sizeof(name), "portfolio_cashflow threads=%d", threads);
+    BenchResult r = {name, BENCH_PROJECT_COUNT, seconds, 0};
+    bench_print_result(&r);
+    printf("  %-34s %12.2fx speedup  (%d solved)\n", "",
+           (baseline > 0.0) ? rate / baseline : 0.0, solved);
+
+    if (threads >= cores)
+      break;
+  }
+
+  free(projects);
+  free(metrics);
+}
+
+void bench_run_portfolio(void) {
+  BondInput *bonds = malloc(BENCH_PORTFOLIO_COUNT * sizeof(BondInput));
+  double *prices = malloc(BENCH_PORTFOLIO_COUNT * sizeof(double));
+  double *yields = malloc(BENCH_PORTFOLIO_COUNT * sizeof(double));
+  BondResult *results = malloc(BENCH_PORTFOLIO_COUNT * sizeof(BondResult));
+
+  if (!bonds || !prices || !yields || !results) {
+    printf("  (skipped: out of memory)\n");
+    free(bonds);
+    free(prices);
+    free(yields);
+    free(results);
+    return;
+  }
+
+  /* Mixed book: maturities 1-30y, some callable, priced off-market */
+  for (int i = 0; i < BENCH_PORTFOLIO_COUNT; i++) {
+    BondInput *b = &bonds[i];
+    b->settlementDate = 20240101 + bench_rand_range(0, 11) * 100;
+    b->maturityDate = (2025 + bench_rand_range(0, 29)) * 10000 + 115;
+    b->callDate = (2026 + bench_rand_range(0, 3)) * 10000 + 115;
+    b->callPrice = 101.0;
+    b->couponRate = bench_rand_range(0, 32) * 0.25;
+    b->redemption = 100.0;
+    b->frequency = (bench_rand() & 1) ? COUPON_SEMI_ANNUAL : COUPON_ANNUAL;
+    b->dayCount = DAY_COUNT_30_360;
+    b->bondType = (bench_rand() % 8 == 0 && b->callDate < b->maturityDate)
+                      ? BOND_TYPE_YTC
+                      : BOND_TYPE_YTM;
+    yields[i] = 0.5 + bench_rand_range(0, 900) / 100.0;
+    prices[i] = bond_price(b, yields[i]);
+    yields[i] = b->couponRate; /* Solve cold from the coupon */
+  }
+
+  int cores = portfolio_default_threads();
+  printf("  %d bonds, %d online processor(s)\n", BENCH_PORTFOLIO_COUNT,
+         cores);
+
+  double baseline = 0.0;
+  for (int threads = 1;; threads *= 2) {
+    if (threads > cores)
+      threads = cores;
+
+    double start = bench_wall_now();
+    int solved = portfolio_calculate(bonds, prices, yields, results, NULL,
+                                     BENCH_PORTFOLIO_COUNT, threads);
+    double seconds = bench_wall_now() - start;
+    double rate = (seconds > 0.0) ? BENCH_PORTFOLIO_COUNT / seconds : 0.0;
+
+    if (threads == 1)
+      baseline = rate;
+    benchSink = results[BENCH_PORTFOLIO_COUNT - 1].duration;
+
+    char name[40];
+    snprintf(name, sizeof(name), "portfolio_calculate threads=%d", threads);
+    BenchResult r = {name, BENCH_PORTFOLIO_COUNT, seconds, 0};
+    bench_print_result(&r);
+    printf("  %-34s %12.2fx speedup  (%d solved)\n", "",
+           (baseline > 0.0) ? rate / baseline : 0.0, solved);
+
+    if (threads >= cores)
+      break;
+  }
+
+  free(bonds);
+  free(prices);
+  free(yields);
+  free(results);
+
+  bench_run_cashflow_portfolio();
+}
+
+/* ============================================================
+ * Compounding Powers
+ * ============================================================ */
+
+#define BENCH_POW_COUNT 4096
+
+/*
+ * Time one case and report its powers per op, and how many of those
+ * still went through exp/log1p. Whole-period powers are squared out;
+ * the rest have fractional exponents (the I/Y seed's 1/q and q, bond
+ * settlement between coupons, the MIRR n-th root) and stay in libm.
+ */
+static void bench_print_pow_case(const char *name, long ops, clock_t start,
+                                 double acc) {
+  BenchResult r = {name, ops, bench_seconds(start), 0};
+  FinPowCounts counts;
+
+  fin_pow_counts(&counts, 1);
+  benchSink = acc;
+  bench_print_result(&r);
+  printf("  %-34s %8.2f pow/op, %.2f via exp/log1p\n", "",
+         (double)(counts.binary + counts.transcendental) / ops,
+         (double)counts.transcendental / ops);
+}
+
+void bench_run_powers(void) {
+  static double rate[BENCH_POW_COUNT], pv[BENCH_POW_COUNT];
+  static double pmt[BENCH_POW_COUNT];
+  static BondInput bonds[BENCH_POW_COUNT];
+  static CashFlowList projects[256];
+  FinPowCounts counts;
+  clock_t start;
+  double acc;
+
+  for (int i = 0; i < BENCH_POW_COUNT; i++) {
+    rate[i] = (2.0 + bench_rand_range(0, 700) / 100.0) / 1200.0;
+    pv[i] = 1000.0 * bench_rand_range(50, 900);
+    pmt[i] = tvm_calc_pmt(360, rate[i], pv[i], 0.0, TVM_END);
+
+    BondInput *b = &bonds[i];
+    b->settlementDate = 20240115;
+    b->maturityDate = (2025 + bench_rand_range(0, 29)) * 10000 + 115;
+    b->callDate = 0;
+    b->callPrice = 100.0;
+    b->couponRate = bench_rand_range(0, 32) * 0.25;
+    b->redemption = 100.0;
+    b->frequency = COUPON_SEMI_ANNUAL;
+    b->dayCount = DAY_COUNT_30_360;
+    b->bondType = BOND_TYPE_YTM;
+  }
+  for (int i = 0; i < 256; i++)
+    bench_random_project(&projects[i]);
+  fin_pow_counts(&counts, 1);
+
+  acc = 0.0;
+  start = clock();
+  for (int i = 0; i < BENCH_POW_COUNT; i++)
+    acc += tvm_calc_fv(360, rate[i], pv[i], pmt[i], TVM_END);
+  bench_print_pow_case("tvm_calc_fv n=360", BENCH_POW_COUNT, start, acc);
+
+  acc = 0.0;
+  start = clock();
+  for (int i = 0; i < BENCH_POW_COUNT; i++)
+    acc += tvm_calc_pmt(360, rate[i], pv[i], 0.0, TVM_END);
+  bench_print_pow_case("tvm_calc_pmt n=360", BENCH_POW_COUNT, start, acc);
+
+  acc = 0.0;
+  start = clock();
+  for (int i = 0; i < BENCH_POW_COUNT; i++) {
+    int err;
+    acc += tvm_calc_iy(360, pv[i], pmt[i], 0.0, TVM_END, &err);
+  }
+  bench_print_pow_case("tvm_calc_iy n=360", BENCH_POW_COUNT, start, acc);
+
+  acc = 0.0;
+  start = clock();
+  for (int i = 0; i < BENCH_POW_COUNT; i++)
+    acc += tvm_amort_period(1 + i % 360, 360, rate[i], pv[i], pmt[i]).balance;
+  bench_print_pow_case("tvm_amort_period", BENCH_POW_COUNT, start, acc);
+
+  /* Worksheet flow: PMT, then FV and PV on the same deal (cached factors) */
+  acc = 0.0;
+  start = clock();
+  for (int i = 0; i < BENCH_POW_COUNT; i++) {
+    Calculator calc;
+    calc_init(&calc, MODEL_STANDARD);
+    calc.tvm.N = 360;
+    calc.tvm.I_Y = rate[i] * 1200.0;
+    calc.tvm.PV = pv[i];
+    calc.tvm.C_Y = 4;
+    acc += tvm_solve_for(&calc, TVM_VAR_PMT);
+    acc += tvm_solve_for(&calc, TVM_VAR_FV);
+    acc += tvm_solve_for(&calc, TVM_VAR_PV);
+  }
+  BenchResult flow = {"tvm_solve_for PMT+FV+PV", BENCH_POW_COUNT,
+                      bench_seconds(start), 0};
+  fin_pow_counts(&counts, 1);
+  benchSink = acc;
+  bench_print_result(&flow);
+  printf("  %-34s %8.2f pow/deal (6 uncached)\n", "",
+         (double)(counts.binary + counts.transcendental) / BENCH_POW_COUNT);
+
+  /* Settlement off the coupon dates, so periods are fractional */
+  acc = 0.0;
+  start = clock();
+  for (int i = 0; i < BENCH_POW_COUNT; i++)
+    acc += bond_price(&bonds[i], 1.0 + (i % 800) / 100.0);
+  bench_print_pow_case("bond_price", BENCH_POW_COUNT, start, acc);
+
+  acc = 0.0;
+  start = clock();
+  for (int i = 0; i < 256; i++) {
+    int err;
+    acc += cf_mirr(&projects[i], 0.08, 0.05, &err);
+  }
+  bench_print_pow_case("cf_mirr", 256, start, acc);
+}
+
+/* ============================================================
+ * Rate Sheet Grid
+ * ============================================================ */
+
+#define BENCH_GRID_RATES 400
+#define BENCH_GRID_TERMS 40
+#define BENCH_GRID_ROUNDS 50
+
+void bench_run_tvm_grid(void) {
+  enum { CELLS = BENCH_GRID_RATES * BENCH_GRID_TERMS };
+  static double rates[BENCH_GRID_RATES];
+  static int terms[BENCH_GRID_TERMS];
+  static double pmt[CELLS], balance[CELLS];
+
+  /* 1.000% to 10.975% in 2.5 bp steps, 1 to 40 years, 5-year balance */
+  for (int r = 0; r < BENCH_GRID_RATES; r++)
+    rates[r] = (1.0 + r * 0.025) / 1200.0;
+  for (int t = 0; t < BENCH_GRID_TERMS; t++)
+    terms[t] = 12 * (t + 1);
+
+  TVMGrid grid = {rates, BENCH_GRID_RATES, terms, BENCH_GRID_TERMS,
+                  250000, 0.0, TVM_END, 60};
+  long ops = (long)CELLS * BENCH_GRID_ROUNDS;
+  BenchResult r;
+  clock_t start;
+  double acc;
+
+  /* Before: one tvm_calc_pmt and one balance per cell */
+  acc = 0.0;
+  start = clock();
+  for (int round = 0; round < BENCH_GRID_ROUNDS; round++) {
+    for (int t = 0; t < BENCH_GRID_TERMS; t++) {
+      for (int k = 0; k < BENCH_GRID_RATES; k++) {
+        double p = tvm_calc_pmt(terms[t], rates[k], 250000, 0.0, TVM_END);
+        pmt[t * BENCH_GRID_RATES + k] = p;
+        balance[t * BENCH_GRID_RATES + k] =
+            -tvm_calc_fv(60, rates[k], 250000, p, TVM_END);
+      }
+    }
+    acc += pmt[round];
+  }
+  r.name = "rate sheet per cell";
+  r.ops = ops;
+  r.iterations = 0;
+  r.seconds = bench_seconds(start);
+  benchSink = acc;
+  bench_print_result(&r);
+
+  /* After: running products down each rate column */
+  acc = 0.0;
+  start = clock();
+  for (int round = 0; round < BENCH_GRID_ROUNDS; round++) {
+    tvm_grid(&grid, pmt, balance);
+    acc += pmt[round];
+  }
+  r.name = "tvm_grid";
+  r.seconds = bench_seconds(start);
+  benchSink = acc;
+  bench_print_result(&r);
+
+  int cores = portfolio_default_threads();
+  double baseline = 0.0;
+  for (int threads = 1;; threads *= 2) {
+    if (threads > cores)
+      threads = cores;
+
+    double wallStart = bench_wall_now();
+    for (int round = 0; round < BENCH_GRID_ROUNDS; round++)
+      portfolio_tvm_grid(&grid, pmt, balance, threads);
+    double seconds = bench_wall_now() - wallStart;
+    double rate = (seconds > 0.0) ? ops / seconds : 0.0;
+
+    if (threads == 1)
+      baseline = rate;
+    benchSink = pmt[CELLS - 1];
+
+    char name[40];
+    snprintf(name, sizeof(name), "portfolio_tvm_grid threads=%d", threads);
+    BenchResult rt = {name, ops, seconds, 0};
+    bench_print_result(&rt);
+    printf("  %-34s %12.2fx speedup\n", "",
+           (baseline > 0.0) ? rate / baseline : 0.0);
+
+    if (threads >= cores)
+      break;
+  }
+}
+
+/* ============================================================
+ * Runner
+ * ============================================================ */
+
+void bench_run_all(void) {
+  printf("\n═══ Benchmark: Date Conversions ═══\n");
+  bench_run_dates();
+
+  printf("\n═══ Benchmark: TVM I/Y Solve ═══\n");
+  bench_run_tvm_iy();
+
+  printf("\n═══ Benchmark: Batch TVM ═══\n");
+  bench_run_tvm_batch();
+
+  printf("\n═══ Benchmark: Amortization Schedule ═══\n");
+  bench_run_amort();
+
+  printf("\n═══ Benchmark: Cash Flows ═══\n");
+  bench_run_cashflow();
+
+  printf("\n═══ Benchmark: Bond Yield ═══\n");
+  bench_run_bond_yield();
+
+  printf("\n═══ Benchmark: Bond Duration ═══\n");
+  bench_run_bond_duration();
+
+  printf("\n═══ Benchmark: Depreciation ═══\n");
+  bench_run_depreciation();
+
+  printf("\n═══ Benchmark: Statistics ═══\n");
+  bench_run_statistics();
+
+  printf("\n═══ Benchmark: Compounding Powers ═══\n");
+  bench_run_powers();
+
+  printf("\n═══ Benchmark: Rate Sheet Grid ═══\n");
+  bench_run_tvm_grid();
+
+  printf("\n═══ Benchmark: Bond Portfolio ═══\n");
+  bench_run_portfolio();
+  printf("\n");
+}
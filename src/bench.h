@@ -0,0 +1,100 @@
+/**
+ * Open fx-BA: TI BA II Plus Clone
+ * bench.h - Host-side microbenchmarks for the financial kernels
+ *
+ * Built only by the host Makefile targets (never part of the add-in).
+ */
+
+#ifndef BENCH_H
+#define BENCH_H
+
+/* ============================================================
+ * Benchmark Result Structure
+ * ============================================================ */
+typedef struct {
+  const char *name; /* Benchmark case name */
+  long ops;         /* Operations timed */
+  double seconds;   /* Wall time for all operations */
+  long iterations;  /* Solver iterations over all ops (0 if not reported) */
+} BenchResult;
+
+/* ============================================================
+ * Benchmark Runner Functions
+ * ============================================================ */
+
+/**
+ * Run every benchmark case and print the results.
+ */
+void bench_run_all(void);
+
+/**
+ * Date conversion cases (legacy year/month loop vs O(1) arithmetic)
+ */
+void bench_run_dates(void);
+
+/**
+ * TVM interest-rate solves (loans, annuities and balloon notes)
+ */
+void bench_run_tvm_iy(void);
+
+/**
+ * Batch TVM cases (Calculator per loan vs structure-of-arrays tape)
+ */
+void bench_run_tvm_batch(void);
+
+/**
+ * Amortization rows (closed form per row vs recurrence, buffered and
+ * streamed)
+ */
+void bench_run_amort(void);
+
+/**
+ * Cash flow projects (NPV, IRR and MIRR)
+ */
+void bench_run_cashflow(void);
+
+/**
+ * Bond yield solves (cold vs warm start, with evaluations per solve)
+ */
+void bench_run_bond_yield(void);
+
+/**
+ * Bond duration (and the full bond_risk set)
+ */
+void bench_run_bond_duration(void);
+
+/**
+ * Depreciation for a random method, life and year, plus full schedules
+ */
+void bench_run_depreciation(void);
+
+/**
+ * Regressions of every type over full 50-point data sets
+ */
+void bench_run_statistics(void);
+
+/**
+ * TVM, amortization, bond and MIRR kernels with fin_powi call counts
+ * (powers per op that were libm pow() calls, and those that still are)
+ */
+void bench_run_powers(void);
+
+/**
+ * Rate x term payment/balance grid (per-cell solves vs running products,
+ * then threaded by rate column)
+ */
+void bench_run_tvm_grid(void);
+
+/**
+ * Multithreaded bond pricing and project screening (items/sec for 1, 2,
+ * 4, ... threads up to the number of online processors)
+ */
+void bench_run_portfolio(void);
+
+/**
+ * Print one result line (ops/sec, ns/op and solver iterations per op when
+ * reported), followed by the same case as a single-line JSON object.
+ */
+void bench_print_result(const BenchResult *r);
+
+#endif /* BENCH_H */
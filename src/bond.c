@@ -4,57 +4,34 @@
  *
  * Implements:
  * - Bond price from yield
- * - Yield to maturity from price (Newton-Raphson)
+ * - Yield to maturity from price (safeguarded Newton-Raphson)
  * - Accrued interest
  * - Macaulay duration
  * - Modified duration (Pro only)
+ *
+ * All entry points take a const BondInput and keep no static state, so
+ * one set of instruments can be priced from several threads at once.
  */
 
 #include "bond.h"
 #include "config.h"
+#include "date.h"
+#include "finmath.h"
+#include "types.h"
 #include <math.h>
+#include <stddef.h>
 
 /* ============================================================
  * Date Helper Functions
  * ============================================================ */
 
-/* Reference date: January 1, 1900 */
-#define REFERENCE_YEAR 1900
-
-static int is_leap_year(int year) {
-  return (year % 4 == 0 && year % 100 != 0) || (year % 400 == 0);
-}
-
-static int days_in_month(int month, int year) {
-  static const int days[] = {0, 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
-
-  if (month == 2 && is_leap_year(year)) {
-    return 29;
-  }
-  return days[month];
-}
-
 int date_to_days(int yyyymmdd) {
   int year = yyyymmdd / 10000;
   int month = (yyyymmdd / 100) % 100;
   int day = yyyymmdd % 100;
 
-  int days = 0;
-
-  /* Add days for complete years */
-  for (int y = REFERENCE_YEAR; y < year; y++) {
-    days += is_leap_year(y) ? 366 : 365;
-  }
-
-  /* Add days for complete months */
-  for (int m = 1; m < month; m++) {
-    days += days_in_month(m, year);
-  }
-
-  /* Add remaining days */
-  days += day;
-
-  return days;
+  /* Shared O(1) conversion; same epoch as the Date worksheet */
+  return (int)date_days_from_civil(year, month, day);
 }
 
 int days_between(int date1, int date2, DayCountConvention convention) {
@@ -95,10 +72,11 @@ int days_in_year(DayCountConvention convention) {
  * Coupon Period Calculations
  * ============================================================ */
 
-/* Calculate number of whole coupon periods remaining */
-static double coupon_periods_remaining(BondInput *input) {
+/* Coupon periods between settlement and a redemption date */
+static double coupon_periods_between(const BondInput *input,
+                                     int redemptionDate) {
   int settleDays = date_to_days(input->settlementDate);
-  int matureDays = date_to_days(input->maturityDate);
+  int matureDays = date_to_days(redemptionDate);
 
   int daysRemaining = matureDays - settleDays;
   int daysPerPeriod = days_in_year(input->dayCount) / (int)input->frequency;
@@ -106,19 +84,93 @@ static double coupon_periods_remaining(BondInput *input) {
   return (double)daysRemaining / (double)daysPerPeriod;
 }
 
+/* Calculate number of whole coupon periods remaining */
+static double coupon_periods_remaining(const BondInput *input) {
+  return coupon_periods_between(input, input->maturityDate);
+}
+
 /* Calculate fraction of current period elapsed (for accrued interest) */
-static double period_fraction_elapsed(BondInput *input) {
+static double period_fraction_elapsed(const BondInput *input) {
   /* Simplified: assume we're at the start of a period */
   /* In a full implementation, this would calculate based on last coupon date */
   double periods = coupon_periods_remaining(input);
   return periods - floor(periods);
 }
 
+/*
+ * Per-period cash flow terms of the priced leg. Everything here depends
+ * only on the bond, not on the yield, so solvers build it once and
+ * reuse it every iteration (no date conversion inside the loop).
+ */
+typedef struct {
+  double coupon;     /* Coupon per period (% of par) */
+  double redemption; /* Redemption or call price */
+  double periods;    /* Coupon periods to redemption (may be fractional) */
+  double frequency;  /* Coupons per year */
+} BondTerms;
+
+static void bond_terms(const BondInput *input, BondTerms *terms) {
+  /*
+   * For callable bonds (YTC mode):
+   *   - Use callDate instead of maturityDate
+   *   - Use callPrice instead of redemption
+   */
+  int redemptionDate = input->maturityDate;
+  terms->redemption = input->redemption;
+
+  if (input->bondType == BOND_TYPE_YTC && input->callDate > 0) {
+    redemptionDate = input->callDate;
+    terms->redemption = input->callPrice;
+  }
+
+  terms->frequency = (double)input->frequency;
+  terms->coupon = input->couponRate / terms->frequency;
+  terms->periods = coupon_periods_between(input, redemptionDate);
+}
+
+/*
+ * Price and dP/d(yield %) from one discount factor.
+ *
+ * With r = yield per period, D = (1+r)^(-n) and A = (1 - D) / r:
+ *   P     = C * A + R * D
+ *   dD/dr = -n * D / (1+r)
+ *   dA/dr = (n * D * r / (1+r) - (1 - D)) / r^2
+ * and dr/d(yield %) = 1 / (100 * frequency).
+ */
+static double bond_terms_price(const BondTerms *terms, double yield,
+                               double *dPrice) {
+  double scale = 1.0 / (100.0 * terms->frequency);
+  double r = yield * scale;
+  double n = terms->periods;
+
+  if (r == 0.0) {
+    /* No discounting; slope is the r -> 0 limit */
+    if (dPrice) {
+      double dA = -n * (n + 1.0) / 2.0;
+      *dPrice = (terms->coupon * dA - terms->redemption * n) * scale;
+    }
+    return terms->coupon * n + terms->redemption;
+  }
+
+  double onePlusRate = 1.0 + r;
+  double discountFactor = fin_powi(r, -n);
+  double annuityFactor = (1.0 - discountFactor) / r;
+
+  if (dPrice) {
+    double dDisc = -n * discountFactor / onePlusRate;
+    double dAnnuity =
+        (n * discountFactor * r / onePlusRate - 1.0 + discountFactor) / (r * r);
+    *dPrice = (terms->coupon * dAnnuity + terms->redemption * dDisc) * scale;
+  }
+
+  return terms->coupon * annuityFactor + terms->redemption * discountFactor;
+}
+
 /* ============================================================
  * Bond Price Calculation
  * ============================================================ */
 
-double bond_price(BondInput *input, double yield) {
+double bond_price(const BondInput *input, double yield) {
   /*
    * Bond price formula:
    * P = C * [1 - (1+r)^(-n)] / r + R * (1+r)^(-n)
@@ -128,87 +180,98 @@ double bond_price(BondInput *input, double yield) {
    *   r = yield per period
    *   n = number of periods
    *   R = redemption value (or call price for YTC)
-   *
-   * For callable bonds (YTC mode):
-   *   - Use callDate instead of maturityDate
-   *   - Use callPrice instead of redemption
    */
+  BondTerms terms;
+  bond_terms(input, &terms);
 
-  /* Determine effective maturity and redemption based on bond type */
-  int effectiveMaturity = input->maturityDate;
-  double effectiveRedemption = input->redemption;
-
-  if (input->bondType == BOND_TYPE_YTC && input->callDate > 0) {
-    effectiveMaturity = input->callDate;
-    effectiveRedemption = input->callPrice;
-  }
-
-  /* Temporarily modify input for calculation */
-  int originalMaturity = input->maturityDate;
-  input->maturityDate = effectiveMaturity;
-
-  double couponPerPeriod = input->couponRate / (double)input->frequency;
-  double yieldPerPeriod = yield / 100.0 / (double)input->frequency;
-  double n = coupon_periods_remaining(input);
-
-  /* Restore original maturity */
-  input->maturityDate = originalMaturity;
-
-  if (yieldPerPeriod == 0.0) {
-    /* No discounting */
-    return couponPerPeriod * n + effectiveRedemption;
-  }
-
-  double discountFactor = pow(1.0 + yieldPerPeriod, -n);
-  double annuityFactor = (1.0 - discountFactor) / yieldPerPeriod;
+  return bond_terms_price(&terms, yield, NULL);
+}
 
-  double price =
-      couponPerPeriod * annuityFactor + effectiveRedemption * discountFactor;
+double bond_price_and_derivative(const BondInput *input, double yield,
+                                 double *dPrice) {
+  BondTerms terms;
+  bond_terms(input, &terms);
 
-  return price;
+  return bond_terms_price(&terms, yield, dPrice);
 }
 
 /* ============================================================
- * Yield to Maturity Calculation (Newton-Raphson)
+ * Yield to Maturity Calculation (safeguarded Newton-Raphson)
  * ============================================================ */
 
-static double bond_price_derivative(BondInput *input, double yield) {
-  double h = 1e-6;
-  double p1 = bond_price(input, yield + h);
-  double p0 = bond_price(input, yield - h);
-  return (p1 - p0) / (2.0 * h);
-}
+/* Yield search interval (% annual), as before */
+#define BOND_YIELD_MIN 0.0
+#define BOND_YIELD_MAX 100.0
 
-double bond_yield(BondInput *input, double price, int *errorCode) {
-  *errorCode = 0;
+double bond_yield_from(const BondInput *input, double price, double guess,
+                       int *iterations, int *errorCode) {
+  *errorCode = ERR_NONE;
+  if (iterations)
+    *iterations = 0;
 
-  /* Initial guess based on coupon rate */
-  double yield = input->couponRate;
-  if (yield <= 0)
-    yield = 5.0; /* Default 5% */
+  BondTerms terms;
+  bond_terms(input, &terms);
+
+  /*
+   * Price falls as yield rises, so [lo, hi] brackets the root as long as
+   * P(lo) >= price >= P(hi). Each Newton step uses the analytic slope;
+   * a step that leaves the bracket is replaced by bisection.
+   */
+  double lo = BOND_YIELD_MIN;
+  double hi = BOND_YIELD_MAX;
+  int hiChecked = 0; /* P(hi) costs a pow, so it is only checked on demand */
+
+  /* P(0) needs no pow: C * n + R */
+  if (price > bond_terms_price(&terms, lo, NULL)) {
+    *errorCode = ERR_NO_SOLUTION;
+    return 0.0;
+  }
+
+  /* Warm start from the caller's guess, else the coupon rate */
+  double yield = guess;
+  if (!(yield > lo && yield < hi)) {
+    yield = input->couponRate;
+    if (yield <= lo || yield >= hi)
+      yield = 5.0; /* Default 5% */
+  }
 
-  /* Newton-Raphson iteration */
   for (int iter = 0; iter < MAX_ITERATIONS; iter++) {
-    double calcPrice = bond_price(input, yield);
-    double diff = calcPrice - price;
+    double slope;
+    double diff = bond_terms_price(&terms, yield, &slope) - price;
+
+    if (iterations)
+      *iterations = iter + 1;
 
     if (fabs(diff) < TOLERANCE) {
       return yield;
     }
 
-    double derivative = bond_price_derivative(input, yield);
-
-    if (fabs(derivative) < 1e-10) {
-      break;
+    /* Shrink the bracket around the root */
+    if (diff > 0.0)
+      lo = yield;
+    else
+      hi = yield;
+
+    double newYield = yield;
+    int bisect = 1;
+    if (slope < 0.0) {
+      newYield = yield - diff / slope;
+      bisect = (newYield <= lo || newYield >= hi);
     }
 
-    double newYield = yield - diff / derivative;
+    if (bisect) {
+      newYield = 0.5 * (lo + hi);
+    }
 
-    /* Bound the yield */
-    if (newYield < 0.0)
-      newYield = 0.001;
-    if (newYield > 100.0)
-      newYield = 100.0;
+    if (bisect && !hiChecked) {
+      /* First bisection step: make sure the top end really brackets */
+      hiChecked = 1;
+      if (hi == BOND_YIELD_MAX &&
+          price < bond_terms_price(&terms, BOND_YIELD_MAX, NULL)) {
+        *errorCode = ERR_NO_SOLUTION;
+        return 0.0;
+      }
+    }
 
     if (fabs(newYield - yield) < TOLERANCE) {
       return newYield;
@@ -217,15 +280,20 @@ double bond_yield(BondInput *input, double price, int *errorCode) {
     yield = newYield;
   }
 
-  *errorCode = 3; /* ERR_ITERATION */
+  *errorCode = ERR_ITERATION;
   return 0.0;
 }
 
+double bond_yield(const BondInput *input, double price, int *errorCode) {
+  /* Initial guess based on coupon rate */
+  return bond_yield_from(input, price, input->couponRate, NULL, errorCode);
+}
+
 /* ============================================================
  * Accrued Interest
  * ============================================================ */
 
-double bond_accrued_interest(BondInput *input) {
+double bond_accrued_interest(const BondInput *input) {
   /*
    * Accrued Interest = (Coupon Rate / Frequency) * (Days since last coupon /
    * Days in period)
@@ -238,82 +306,118 @@ double bond_accrued_interest(BondInput *input) {
 }
 
 /* ============================================================
- * Macaulay Duration
+ * Duration, Convexity and DV01
  * ============================================================ */
 
-double bond_duration(BondInput *input, double yield) {
+BondRisk bond_risk(const BondInput *input, double yield) {
   /*
-   * Macaulay Duration:
-   * D = Σ [t * CF(t) * (1+r)^(-t)] / Price
+   * Every measure is a derivative of the same closed-form price that
+   * bond_price and bond_yield use, so they stay consistent with each other
+   * for fractional periods too. With D = (1+r)^(-n) and A = (1 - D) / r:
+   *   D'  = -n * D / (1+r)            D'' = n(n+1) * D / (1+r)^2
+   *   A'  = -(D' + A) / r             A'' = -(D'' + 2A') / r
+   *   P'  = C * A'  + R * D'          P'' = C * A'' + R * D''
+   * then, in periods:
+   *   Macaulay D = -P' * (1+r) / P     Modified D = -P' / P
+   *   Convexity  = P'' / P
+   * For whole periods these equal the schedule sums Σ t*CF(t)*v^t / P and
+   * Σ t(t+1)*CF(t)*v^(t+2) / P, but cost the one fin_powi() of the price.
+   *
+   * Uses the same leg as bond_price (call date and price for YTC).
    */
+  BondRisk risk = {0.0, 0.0, 0.0, 0.0, 0.0};
+
+  BondTerms terms;
+  bond_terms(input, &terms);
+
+  double f = terms.frequency;
+  double r = yield / 100.0 / f;
+  double n = terms.periods;
+  double C = terms.coupon;
+  double R = terms.redemption;
+  double onePlusRate = 1.0 + r;
+  double dP, d2P;
+
+  if (r == 0.0) {
+    /* No discounting; derivatives are the r -> 0 limits */
+    risk.price = C * n + R;
+    dP = -C * n * (n + 1.0) / 2.0 - R * n;
+    d2P = C * n * (n + 1.0) * (n + 2.0) / 3.0 + R * n * (n + 1.0);
+  } else {
+    double D = fin_powi(r, -n);
+    double A = (1.0 - D) / r;
+    double dD = -n * D / onePlusRate;
+    double d2D = n * (n + 1.0) * D / (onePlusRate * onePlusRate);
+    double dA = -(dD + A) / r;
+    double d2A = -(d2D + 2.0 * dA) / r;
+
+    risk.price = C * A + R * D;
+    dP = C * dA + R * dD;
+    d2P = C * d2A + R * d2D;
+  }
 
-  double couponPerPeriod = input->couponRate / (double)input->frequency;
-  double yieldPerPeriod = yield / 100.0 / (double)input->frequency;
-  double n = coupon_periods_remaining(input);
-  int periods = (int)ceil(n);
-  double redemption = input->redemption;
-
-  double price = bond_price(input, yield);
-  if (price <= 0)
-    return 0.0;
-
-  double weightedSum = 0.0;
+  /* dr/d(yield %) = 1 / (100 f); DV01 is per 0.01% */
+  risk.dv01 = -dP / (100.0 * f) / 100.0;
+  if (risk.price <= 0)
+    return risk;
 
-  for (int t = 1; t <= periods; t++) {
-    double cf = couponPerPeriod;
-    if (t == periods) {
-      cf += redemption; /* Add principal at maturity */
-    }
+  risk.modDuration = -dP / risk.price / f;
+  risk.duration = risk.modDuration * onePlusRate;
+  risk.convexity = d2P / risk.price / (f * f);
 
-    double pv = cf / pow(1.0 + yieldPerPeriod, (double)t);
-    weightedSum += (double)t * pv;
-  }
+  return risk;
+}
 
-  /* Convert to years */
-  double durationPeriods = weightedSum / price;
-  double durationYears = durationPeriods / (double)input->frequency;
+/* ============================================================
+ * Macaulay Duration
+ * ============================================================ */
 
-  return durationYears;
+double bond_duration(const BondInput *input, double yield) {
+  return bond_risk(input, yield).duration;
 }
 
 /* ============================================================
  * Modified Duration (Pro only)
  * ============================================================ */
 
-double bond_modified_duration(BondInput *input, double yield) {
+double bond_modified_duration(const BondInput *input, double yield) {
   /*
    * Modified Duration = Macaulay Duration / (1 + yield/frequency)
    */
-
-  double macDuration = bond_duration(input, yield);
-  double yieldPerPeriod = yield / 100.0 / (double)input->frequency;
-
-  return macDuration / (1.0 + yieldPerPeriod);
+  return bond_risk(input, yield).modDuration;
 }
 
 /* ============================================================
  * Full Bond Calculation
  * ============================================================ */
 
-BondResult bond_calculate(BondInput *input, double knownPrice,
-                          double knownYield) {
+BondResult bond_calculate(const BondInput *input, double knownPrice,
+                          double knownYield, int *errorCode) {
   BondResult result = {0};
-  int errorCode = 0;
+  int yieldError = ERR_NONE;
 
   if (knownPrice > 0) {
-    /* Solve for yield */
+    /* Solve for yield, warm-started from the last known yield */
     result.price = knownPrice;
-    result.yield = bond_yield(input, knownPrice, &errorCode);
+    result.yield =
+        bond_yield_from(input, knownPrice, knownYield, NULL, &yieldError);
   } else {
     /* Solve for price */
     result.yield = knownYield;
     result.price = bond_price(input, knownYield);
   }
 
+  /* One pass for every yield sensitivity */
+  BondRisk risk = bond_risk(input, result.yield);
+
   result.accruedInterest = bond_accrued_interest(input);
   result.dirtyPrice = result.price + result.accruedInterest;
-  result.duration = bond_duration(input, result.yield);
-  result.modDuration = bond_modified_duration(input, result.yield);
+  result.duration = risk.duration;
+  result.modDuration = risk.modDuration;
+  result.convexity = risk.convexity;
+  result.dv01 = risk.dv01;
 
+  if (errorCode)
+    *errorCode = yieldError;
   return result;
 }
@@ -76,10 +76,26 @@ typedef struct {
   double dirtyPrice;      /* Clean price + accrued interest */
   double duration;        /* Macaulay duration (years) */
   double modDuration;     /* Modified duration (Pro only) */
+  double convexity;       /* Convexity (years^2) */
+  double dv01;            /* Price gain per 1bp fall in yield (% of par) */
 } BondResult;
 
+/* ============================================================
+ * Bond Risk Structure
+ * ============================================================ */
+typedef struct {
+  double price;       /* Clean price (% of par) */
+  double duration;    /* Macaulay duration (years) */
+  double modDuration; /* Modified duration (years) */
+  double convexity;   /* Convexity (years^2) */
+  double dv01;        /* Price gain per 1bp fall in yield (% of par) */
+} BondRisk;
+
 /* ============================================================
  * Bond Calculation Functions
+ *
+ * Inputs are read-only and no function keeps hidden state, so a shared
+ * BondInput may be priced from several threads concurrently.
  * ============================================================ */
 
 /**
@@ -89,18 +105,44 @@ typedef struct {
  * @param yield Yield to maturity (% annual)
  * @return Price as % of par
  */
-double bond_price(BondInput *input, double yield);
+double bond_price(const BondInput *input, double yield);
+
+/**
+ * Calculate bond price and its slope in one pass.
+ * The slope reuses the price's discount factor (no finite differences).
+ *
+ * @param input Bond parameters
+ * @param yield Yield to maturity (% annual)
+ * @param dPrice Output: dPrice/dYield per 1% of yield (may be NULL)
+ * @return Price as % of par
+ */
+double bond_price_and_derivative(const BondInput *input, double yield,
+                                 double *dPrice);
 
 /**
  * Calculate yield to maturity given price.
- * Uses Newton-Raphson iteration.
+ * Uses Newton-Raphson with analytic slope and a bisection fallback,
+ * starting from the coupon rate.
  *
  * @param input Bond parameters
  * @param price Clean price (% of par)
- * @param errorCode Output: set if no solution found
+ * @param errorCode Output: as bond_yield_from
  * @return Yield to maturity (%)
  */
-double bond_yield(BondInput *input, double price, int *errorCode);
+double bond_yield(const BondInput *input, double price, int *errorCode);
+
+/**
+ * Calculate yield given price, warm-started from a previous yield.
+ *
+ * @param guess Starting yield (%); ignored unless within (0, 100)
+ * @param iterations Output: price evaluations used (may be NULL)
+ * @param errorCode Output: ERR_NONE, ERR_NO_SOLUTION if price is outside
+ *                  the 0-100% yield range, or ERR_ITERATION if the
+ *                  iteration limit is hit
+ * @return Yield (%)
+ */
+double bond_yield_from(const BondInput *input, double price, double guess,
+                       int *iterations, int *errorCode);
 
 /**
  * Calculate accrued interest.
@@ -108,7 +150,20 @@ double bond_yield(BondInput *input, double price, int *errorCode);
  * @param input Bond parameters
  * @return Accrued interest (% of par)
  */
-double bond_accrued_interest(BondInput *input);
+double bond_accrued_interest(const BondInput *input);
+
+/**
+ * Price and first/second-order yield sensitivities in one pass.
+ *
+ * Durations and convexity are the first and second yield derivatives of
+ * the closed-form price, so the whole set costs the price's single pow()
+ * and stays consistent with bond_price and bond_yield.
+ *
+ * @param input Bond parameters
+ * @param yield Yield to maturity (%)
+ * @return Price, Macaulay and modified duration, convexity and DV01
+ */
+BondRisk bond_risk(const BondInput *input, double yield);
 
 /**
  * Calculate Macaulay duration.
@@ -117,7 +172,7 @@ double bond_accrued_interest(BondInput *input);
  * @param yield Yield to maturity (%)
  * @return Duration in years
  */
-double bond_duration(BondInput *input, double yield);
+double bond_duration(const BondInput *input, double yield);
 
 /**
  * Calculate Modified duration (Pro only).
@@ -127,7 +182,7 @@ double bond_duration(BondInput *input, double yield);
  * @param yield Yield to maturity (%)
  * @return Modified duration
  */
-double bond_modified_duration(BondInput *input, double yield);
+double bond_modified_duration(const BondInput *input, double yield);
 
 /**
  * Full bond calculation - computes all values.
@@ -135,11 +190,14 @@ double bond_modified_duration(BondInput *input, double yield);
  * @param input Bond parameters
  * @param knownPrice If > 0, solve for yield; otherwise solve for price using
  * knownYield
- * @param knownYield Used if knownPrice <= 0
+ * @param knownYield Used if knownPrice <= 0; otherwise the warm start for
+ * the yield solve
+ * @param errorCode Output: ERR_* from the yield solve, ERR_NONE when
+ * solving for price (may be NULL)
  * @return Complete bond result
  */
-BondResult bond_calculate(BondInput *input, double knownPrice,
-                          double knownYield);
+BondResult bond_calculate(const BondInput *input, double knownPrice,
+                          double knownYield, int *errorCode);
 
 /* ============================================================
  * Date Helper Functions
@@ -5,9 +5,167 @@
 
 #include "cashflow.h"
 #include "config.h"
+#include "finmath.h"
 #include <math.h>
+#include <stdint.h>
 #include <string.h>
 
+/* ============================================================
+ * Flow Views
+ * ============================================================ */
+
+/*
+ * Every kernel reads flows through this SoA view, so the embedded
+ * CashFlowList and an arena-backed CashFlowSeries share one
+ * implementation.
+ */
+typedef struct {
+  double CF0;
+  const double *amount;
+  const int *frequency;
+  int count;
+} CfView;
+
+static CfView cf_view(const CashFlowList *cf) {
+  CfView view = {cf->CF0, cf->amount, cf->frequency, cf->count};
+  return view;
+}
+
+static CfView cf_series_view(const CashFlowSeries *series) {
+  CfView view = {series->CF0, series->amount, series->frequency,
+                 series->count};
+  return view;
+}
+
+static int cf_view_periods(const CfView *cf) {
+  int total = 0;
+  for (int i = 0; i < cf->count; i++) {
+    total += cf->frequency[i];
+  }
+  return total;
+}
+
+/* Same clamp as the TI frequency entry: 1..9999 */
+static int cf_clamp_frequency(int frequency) {
+  if (frequency < 1)
+    return 1;
+  if (frequency > 9999)
+    return 9999;
+  return frequency;
+}
+
+/* ============================================================
+ * Grouped Discounting Helpers
+ * ============================================================ */
+
+/*
+ * A group of `freq` equal flows starting after `p` earlier periods is a
+ * geometric series, so its value and slope come out in O(1):
+ *
+ *   sum_{j=1..k} v^(p+j)          = v^p * A,        A = (1 - v^k) / r
+ *   sum_{j=1..k} (p+j) * v^(p+j)  = v^p * (p*A + B), B = sum_{j=1..k} j*v^j
+ *
+ * where v = 1/(1+r). B = ((1+r)*A - k*v^k) / r cancels badly when k*r is
+ * tiny, so a short Taylor series in r is used there instead.
+ *
+ * @param lnOnePlusRate log1p(rate), hoisted by the caller
+ * @param vk Output: v^k, the discount across the whole group
+ * @param annuity Output: A
+ * @param weighted Output: B (may be NULL when no derivative is needed)
+ */
+static void cf_group_factors(double rate, double lnOnePlusRate, int freq,
+                             double *vk, double *annuity, double *weighted) {
+  double k = (double)freq;
+
+  if (freq == 1) {
+    /* Single flow: no transcendental calls needed */
+    double v = 1.0 / (1.0 + rate);
+    *vk = v;
+    *annuity = v;
+    if (weighted)
+      *weighted = v;
+    return;
+  }
+
+  if (rate == 0.0) {
+    *vk = 1.0;
+    *annuity = k;
+    if (weighted)
+      *weighted = k * (k + 1.0) / 2.0;
+    return;
+  }
+
+  /* expm1 keeps 1 - v^k accurate for small rates */
+  double x = -k * lnOnePlusRate;
+  *vk = exp(x);
+  *annuity = -expm1(x) / rate;
+
+  if (!weighted)
+    return;
+
+  if (fabs(rate) * k < 1e-3) {
+    /* B = S1 - r*S2 + r^2*(S3 + S2)/2 + O((k*r)^3) */
+    double s1 = k * (k + 1.0) / 2.0;
+    double s2 = s1 * (2.0 * k + 1.0) / 3.0;
+    double s3 = s1 * s1;
+    *weighted = s1 - rate * s2 + rate * rate * (s3 + s2) / 2.0;
+  } else {
+    *weighted = ((1.0 + rate) * *annuity - k * *vk) / rate;
+  }
+}
+
+/* ============================================================
+ * Discounting Cache
+ * ============================================================ */
+
+#define CF_CACHE_RESYNC 64 /* O(1) NPV updates between full re-sums */
+
+/*
+ * Rebuild the per-group unit values at `rate`. unitValue[j] is the PV of
+ * 1 paid each period of group j, so the group adds amount * unitValue[j]
+ * to NPV and an amount edit moves NPV by (new - old) * unitValue[j].
+ */
+static void cf_cache_build(CashFlowList *cf, double rate) {
+  CashFlowCache *cache = &cf->cache;
+  double discountFactor = 1.0; /* v^p: discount to the start of the group */
+  double lnOnePlusRate = log1p(rate);
+  double npv = cf->CF0;
+
+  for (int i = 0; i < cf->count; i++) {
+    double vk, annuity;
+    cf_group_factors(rate, lnOnePlusRate, cf->frequency[i], &vk,
+                     &annuity, NULL);
+
+    cache->unitValue[i] = discountFactor * annuity;
+    npv += cf->amount[i] * discountFactor * annuity;
+    discountFactor *= vk;
+  }
+
+  cache->valid = 1;
+  cache->edits = 0;
+  cache->rate = rate;
+  cache->npv = npv;
+  cache->endDiscount = discountFactor;
+}
+
+/*
+ * Count one O(1) NPV update; every CF_CACHE_RESYNC of them the NPV is
+ * re-summed from the unit values so rounding cannot build up.
+ */
+static void cf_cache_edited(CashFlowList *cf) {
+  CashFlowCache *cache = &cf->cache;
+
+  if (++cache->edits < CF_CACHE_RESYNC)
+    return;
+
+  double npv = cf->CF0;
+  for (int i = 0; i < cf->count; i++)
+    npv += cf->amount[i] * cache->unitValue[i];
+
+  cache->npv = npv;
+  cache->edits = 0;
+}
+
 /* ============================================================
  * Cash Flow List Management
  * ============================================================ */
@@ -15,25 +173,45 @@
 void cf_init(CashFlowList *cf) {
   cf->CF0 = 0.0;
   cf->count = 0;
-  memset(cf->flows, 0, sizeof(cf->flows));
+  memset(cf->amount, 0, sizeof(cf->amount));
+  memset(cf->frequency, 0, sizeof(cf->frequency));
+  memset(&cf->cache, 0, sizeof(cf->cache));
 }
 
-void cf_set_cf0(CashFlowList *cf, double amount) { cf->CF0 = amount; }
+void cf_set_cf0(CashFlowList *cf, double amount) {
+  if (cf->cache.valid) {
+    cf->cache.npv += amount - cf->CF0;
+    cf_cache_edited(cf);
+  }
+  cf->CF0 = amount;
+}
 
 int cf_add(CashFlowList *cf, double amount, int frequency) {
   if (cf->count >= MAX_CASH_FLOWS) {
     return -1;
   }
 
-  /* Default frequency is 1 */
-  if (frequency < 1)
-    frequency = 1;
-  if (frequency > 9999)
-    frequency = 9999; /* TI limit */
+  /* Default frequency is 1; TI limit is 9999 */
+  frequency = cf_clamp_frequency(frequency);
+
+  cf->amount[cf->count] = amount;
+  cf->frequency[cf->count] = frequency;
 
-  cf->flows[cf->count].amount = amount;
-  cf->flows[cf->count].frequency = frequency;
-  cf->count++;
+  if (cf->cache.valid) {
+    /* The new group starts where the last one ended */
+    CashFlowCache *cache = &cf->cache;
+    double vk, annuity;
+    cf_group_factors(cache->rate, log1p(cache->rate), frequency, &vk,
+                     &annuity, NULL);
+
+    cache->unitValue[cf->count] = cache->endDiscount * annuity;
+    cache->endDiscount *= vk;
+    cache->npv += amount * cache->unitValue[cf->count];
+    cf->count++;
+    cf_cache_edited(cf);
+  } else {
+    cf->count++;
+  }
 
   return cf->count - 1;
 }
@@ -42,13 +220,24 @@ void cf_update(CashFlowList *cf, int index, double amount, int frequency) {
   if (index < 0 || index >= cf->count)
     return;
 
-  if (frequency < 1)
-    frequency = 1;
-  if (frequency > 9999)
-    frequency = 9999;
+  frequency = cf_clamp_frequency(frequency);
+
+  CashFlowCache *cache = &cf->cache;
+
+  if (cache->valid && frequency == cf->frequency[index]) {
+    /* Same timing: only this group's contribution moves */
+    cache->npv += (amount - cf->amount[index]) * cache->unitValue[index];
+    cf->amount[index] = amount;
+    cf_cache_edited(cf);
+    return;
+  }
+
+  cf->amount[index] = amount;
+  cf->frequency[index] = frequency;
 
-  cf->flows[index].amount = amount;
-  cf->flows[index].frequency = frequency;
+  /* New frequency shifts every later group: rebuild at the same rate */
+  if (cache->valid)
+    cf_cache_build(cf, cache->rate);
 }
 
 void cf_delete(CashFlowList *cf, int index) {
@@ -57,190 +246,1083 @@ void cf_delete(CashFlowList *cf, int index) {
 
   /* Shift remaining flows down */
   for (int i = index; i < cf->count - 1; i++) {
-    cf->flows[i] = cf->flows[i + 1];
+    cf->amount[i] = cf->amount[i + 1];
+    cf->frequency[i] = cf->frequency[i + 1];
   }
 
   cf->count--;
+  cf->cache.valid = 0;
 }
 
 int cf_total_periods(CashFlowList *cf) {
-  int total = 0;
-  for (int i = 0; i < cf->count; i++) {
-    total += cf->flows[i].frequency;
+  CfView view = cf_view(cf);
+  return cf_view_periods(&view);
+}
+
+/* ============================================================
+ * Arena-Backed Series Management
+ * ============================================================ */
+
+#define CF_ARENA_ALIGN 64 /* Arrays start on a cache line */
+
+void cf_arena_init(CashFlowArena *arena, void *buffer, size_t size) {
+  arena->base = (unsigned char *)buffer;
+  arena->size = buffer ? size : 0;
+  arena->used = 0;
+}
+
+void cf_arena_reset(CashFlowArena *arena) { arena->used = 0; }
+
+/* First offset at or after `offset` whose address is CF_ARENA_ALIGN-aligned */
+static size_t cf_arena_align(const CashFlowArena *arena, size_t offset) {
+  uintptr_t address = (uintptr_t)(arena->base + offset);
+  uintptr_t misalign = address % CF_ARENA_ALIGN;
+  return misalign ? offset + (CF_ARENA_ALIGN - misalign) : offset;
+}
+
+/*
+ * One block holds amount[capacity] then frequency[capacity]. If the
+ * series' block is the newest in the arena it grows where it stands;
+ * otherwise a new block is carved and the old one is left until the arena
+ * is reset.
+ */
+static int cf_series_reserve(CashFlowSeries *series, int capacity) {
+  CashFlowArena *arena = series->arena;
+  size_t amountBytes = (size_t)capacity * sizeof(double);
+  amountBytes += (CF_ARENA_ALIGN - amountBytes % CF_ARENA_ALIGN) %
+                 CF_ARENA_ALIGN;
+  size_t bytes = amountBytes + (size_t)capacity * sizeof(int);
+
+  unsigned char *old = (unsigned char *)series->amount;
+  size_t oldBytes = 0;
+  if (old) {
+    oldBytes = (size_t)((unsigned char *)(series->frequency +
+                                          series->capacity) - old);
   }
-  return total;
+
+  size_t offset;
+  if (old && old + oldBytes == arena->base + arena->used)
+    offset = (size_t)(old - arena->base);
+  else
+    offset = cf_arena_align(arena, arena->used);
+
+  if (offset > arena->size || bytes > arena->size - offset)
+    return 0;
+
+  unsigned char *block = arena->base + offset;
+  double *amount = (double *)block;
+  int *frequency = (int *)(block + amountBytes);
+
+  /* Frequencies first: growing in place moves them over old space */
+  if (series->count > 0) {
+    memmove(frequency, series->frequency,
+            (size_t)series->count * sizeof(int));
+    memmove(amount, series->amount, (size_t)series->count * sizeof(double));
+  }
+
+  series->amount = amount;
+  series->frequency = frequency;
+  series->capacity = capacity;
+  arena->used = offset + bytes;
+  return 1;
+}
+
+int cf_series_init(CashFlowSeries *series, CashFlowArena *arena,
+                   int capacity) {
+  series->CF0 = 0.0;
+  series->amount = NULL;
+  series->frequency = NULL;
+  series->count = 0;
+  series->capacity = 0;
+  series->arena = arena;
+
+  return capacity <= 0 || cf_series_reserve(series, capacity);
+}
+
+int cf_series_add(CashFlowSeries *series, double amount, int frequency) {
+  if (series->count == series->capacity) {
+    int grown = series->capacity ? 2 * series->capacity : 16;
+    if (!cf_series_reserve(series, grown) &&
+        !cf_series_reserve(series, series->count + 1))
+      return -1;
+  }
+
+  series->amount[series->count] = amount;
+  series->frequency[series->count] = cf_clamp_frequency(frequency);
+  series->count++;
+
+  return series->count - 1;
+}
+
+int cf_series_total_periods(const CashFlowSeries *series) {
+  CfView view = cf_series_view(series);
+  return cf_view_periods(&view);
 }
 
 /* ============================================================
  * NPV Calculation (OPTIMIZED)
  * ============================================================ */
 
+/*
+ * NPV = CF0 + sum(CFj / (1+r)^t)
+ *
+ * OPTIMIZED: Each group is summed as a geometric series, so the
+ * cost is O(count) regardless of frequencies (a 9999-period run costs
+ * the same as a single flow). The solvers call this directly so that
+ * their trial rates leave the cache alone.
+ */
+static double cf_npv_at(const CfView *cf, double rate) {
+  double npv = cf->CF0;
+  double discountFactor = 1.0; /* v^p: discount to the start of the group */
+  double lnOnePlusRate = log1p(rate);
+
+  for (int i = 0; i < cf->count; i++) {
+    double vk, annuity;
+    cf_group_factors(rate, lnOnePlusRate, cf->frequency[i], &vk,
+                     &annuity, NULL);
+
+    npv += cf->amount[i] * discountFactor * annuity;
+    discountFactor *= vk;
+  }
+
+  return npv;
+}
+
 double cf_npv(CashFlowList *cf, double rate) {
-  /*
-   * NPV = CF0 + sum(CFj / (1+r)^t)
-   * 
-   * OPTIMIZED: Use iterative discount factor multiplication instead
-   * of calling pow() for each period. This is O(n) multiplications
-   * instead of O(n) pow() calls (which are expensive).
-   */
+  /* Same rate as last time: the cache has followed every edit since */
+  if (!cf->cache.valid || cf->cache.rate != rate)
+    cf_cache_build(cf, rate);
+
+  return cf->cache.npv;
+}
+
+double cf_series_npv(const CashFlowSeries *series, double rate) {
+  CfView view = cf_series_view(series);
+  return cf_npv_at(&view, rate);
+}
+
+/* ============================================================
+ * NPV Profile (many rates, one pass over the flows)
+ * ============================================================ */
+
+#define CF_PROFILE_BLOCK 32       /* Rates per pass; scratch on the stack */
+#define CF_PROFILE_SMALL_KR 0.05  /* Below this k*|r|, 1 - v^k cancels */
+
+/*
+ * Groups are the outer loop and rates the inner one, so each group is
+ * read once per block of rates and the per-rate updates are independent
+ * multiply-adds the compiler can vectorize. Instead of exp/expm1 per rate,
+ * v^k comes from binary powering of v, sharing the bit loop across the
+ * block, and is only redone when the frequency differs from the previous
+ * group's. That agrees with cf_npv to about 1e-14 of the flow total;
+ * where k*|r| is small, 1 - v^k would cancel, so those rates fall back to
+ * cf_group_factors.
+ */
+static void cf_view_npv_profile(const CfView *cf, const double rates[],
+                                double out[], int k) {
+  double lnOnePlusRate[CF_PROFILE_BLOCK];
+  double v[CF_PROFILE_BLOCK];
+  double discountFactor[CF_PROFILE_BLOCK];
+  double vk[CF_PROFILE_BLOCK];
+  double annuity[CF_PROFILE_BLOCK];
+  double power[CF_PROFILE_BLOCK];
+  double npv[CF_PROFILE_BLOCK];
+
+  for (int base = 0; base < k; base += CF_PROFILE_BLOCK) {
+    const double *rate = rates + base;
+    int m = k - base < CF_PROFILE_BLOCK ? k - base : CF_PROFILE_BLOCK;
+    int factorsFreq = 0; /* Frequency vk/annuity currently hold */
+
+    for (int r = 0; r < m; r++) {
+      lnOnePlusRate[r] = log1p(rate[r]);
+      v[r] = 1.0 / (1.0 + rate[r]);
+      discountFactor[r] = 1.0;
+      npv[r] = cf->CF0;
+    }
+
+    for (int i = 0; i < cf->count; i++) {
+      double amount = cf->amount[i];
+      int freq = cf->frequency[i];
+
+      if (freq == 1) {
+        for (int r = 0; r < m; r++) {
+          npv[r] += amount * discountFactor[r] * v[r];
+          discountFactor[r] *= v[r];
+        }
+        continue;
+      }
+
+      if (freq != factorsFreq) {
+        /* v^k by binary powering; the bit loop is shared by all rates */
+        for (int r = 0; r < m; r++) {
+          vk[r] = 1.0;
+          power[r] = v[r];
+        }
+        for (int e = freq; e; e >>= 1) {
+          if (e & 1) {
+            for (int r = 0; r < m; r++)
+              vk[r] *= power[r];
+          }
+          if (e > 1) {
+            for (int r = 0; r < m; r++)
+              power[r] *= power[r];
+          }
+        }
+        for (int r = 0; r < m; r++)
+          annuity[r] = (1.0 - vk[r]) / rate[r];
+
+        /* 1 - v^k cancels when k*r is small: use the expm1 form there */
+        for (int r = 0; r < m; r++) {
+          if (fabs(rate[r]) * freq < CF_PROFILE_SMALL_KR)
+            cf_group_factors(rate[r], lnOnePlusRate[r], freq, &vk[r],
+                             &annuity[r], NULL);
+        }
+        factorsFreq = freq;
+      }
+
+      for (int r = 0; r < m; r++) {
+        npv[r] += amount * discountFactor[r] * annuity[r];
+        discountFactor[r] *= vk[r];
+      }
+    }
+
+    memcpy(out + base, npv, (size_t)m * sizeof(double));
+  }
+}
+
+void cf_npv_profile(CashFlowList *cf, const double rates[], double out[],
+                    int k) {
+  CfView view = cf_view(cf);
+  cf_view_npv_profile(&view, rates, out, k);
+}
+
+void cf_series_npv_profile(const CashFlowSeries *series, const double rates[],
+                           double out[], int k) {
+  CfView view = cf_series_view(series);
+  cf_view_npv_profile(&view, rates, out, k);
+}
+
+/* ============================================================
+ * Term-Structure Discounting
+ * ============================================================ */
+
+/* Carve both tables of a curve from one arena block */
+static int cf_curve_alloc(DiscountCurve *curve, CashFlowArena *arena,
+                          int periods) {
+  size_t count = (size_t)periods + 1;
+  size_t offset = cf_arena_align(arena, arena->used);
+  size_t bytes = 2 * count * sizeof(double);
+
+  curve->discount = NULL;
+  curve->cumulative = NULL;
+  curve->periods = 0;
+
+  if (offset > arena->size || bytes > arena->size - offset)
+    return 0;
+
+  curve->discount = (double *)(arena->base + offset);
+  curve->cumulative = curve->discount + count;
+  curve->periods = periods;
+  arena->used = offset + bytes;
+  return 1;
+}
+
+/* Fill cumulative[] from discount[] once the factors are in place */
+static void cf_curve_accumulate(DiscountCurve *curve) {
+  double sum = 0.0;
+  curve->cumulative[0] = 0.0;
+  for (int p = 1; p <= curve->periods; p++) {
+    sum += curve->discount[p];
+    curve->cumulative[p] = sum;
+  }
+}
+
+int cf_curve_from_rates(DiscountCurve *curve, CashFlowArena *arena,
+                        const double rates[], int periods) {
+  if (periods < 0)
+    return ERR_INVALID_INPUT;
+  for (int p = 0; p < periods; p++) {
+    if (!(rates[p] > -1.0))
+      return ERR_INVALID_INPUT;
+  }
+  if (!cf_curve_alloc(curve, arena, periods))
+    return ERR_OVERFLOW;
 
+  /* Rate p applies from period p to p+1 */
+  curve->discount[0] = 1.0;
+  for (int p = 1; p <= periods; p++)
+    curve->discount[p] = curve->discount[p - 1] / (1.0 + rates[p - 1]);
+
+  cf_curve_accumulate(curve);
+  return ERR_NONE;
+}
+
+int cf_curve_from_zeros(DiscountCurve *curve, CashFlowArena *arena,
+                        const double tenors[], const double zeros[],
+                        int knots, CurveInterpolation interpolation,
+                        int periods) {
+  if (periods < 0 || knots <= 0)
+    return ERR_INVALID_INPUT;
+  for (int k = 0; k < knots; k++) {
+    if (!(zeros[k] > -1.0) || !(tenors[k] > 0.0) ||
+        (k > 0 && !(tenors[k] > tenors[k - 1])))
+      return ERR_INVALID_INPUT;
+  }
+  if (!cf_curve_alloc(curve, arena, periods))
+    return ERR_OVERFLOW;
+
+  curve->discount[0] = 1.0;
+  int k = 0; /* Knot at or after period p (knots - 1 past the last) */
+
+  for (int p = 1; p <= periods; p++) {
+    double t = (double)p;
+    double lnDiscount;
+
+    while (k < knots - 1 && tenors[k] < t)
+      k++;
+
+    if (t <= tenors[0] || t >= tenors[knots - 1]) {
+      /* Flat zero rate outside the knots */
+      double zero = zeros[t <= tenors[0] ? 0 : knots - 1];
+      lnDiscount = -t * log1p(zero);
+    } else {
+      double t0 = tenors[k - 1], t1 = tenors[k];
+      double w = (t - t0) / (t1 - t0);
+
+      if (interpolation == CURVE_LINEAR_ZERO) {
+        double zero = zeros[k - 1] + w * (zeros[k] - zeros[k - 1]);
+        lnDiscount = -t * log1p(zero);
+      } else {
+        /* Linear in log discount factor: flat forwards between knots */
+        double ln0 = -t0 * log1p(zeros[k - 1]);
+        double ln1 = -t1 * log1p(zeros[k]);
+        lnDiscount = ln0 + w * (ln1 - ln0);
+      }
+    }
+
+    curve->discount[p] = exp(lnDiscount);
+  }
+
+  cf_curve_accumulate(curve);
+  return ERR_NONE;
+}
+
+/*
+ * With the running sums in the table a group of k flows from period p+1
+ * to p+k is worth amount * (cumulative[p+k] - cumulative[p]), so NPV is
+ * a dot product of the amounts with table differences.
+ */
+static double cf_view_npv_curve(const CfView *cf, const DiscountCurve *curve,
+                                int *periods, int *errorCode) {
+  const double *discount = curve->discount;
+  const double *cumulative = curve->cumulative;
   double npv = cf->CF0;
-  double discountFactor = 1.0;
-  double onePlusRate = 1.0 + rate;
+  int period = 0;
 
-  for (int i = 0; i < cf->count; i++) {
-    double amount = cf->flows[i].amount;
-    int freq = cf->flows[i].frequency;
+  *errorCode = ERR_NONE;
 
-    for (int f = 0; f < freq; f++) {
-      discountFactor /= onePlusRate;  /* Equivalent to 1/(1+r)^period */
-      npv += amount * discountFactor;
+  for (int i = 0; i < cf->count; i++) {
+    int freq = cf->frequency[i];
+    if (freq > curve->periods - period) {
+      /* Flows run past the end of the curve */
+      *errorCode = ERR_INVALID_INPUT;
+      return 0.0;
     }
+
+    /* A single flow reads its factor directly, with no cancellation */
+    double sum = (freq == 1) ? discount[period + 1]
+                             : cumulative[period + freq] - cumulative[period];
+    npv += cf->amount[i] * sum;
+    period += freq;
   }
 
+  if (periods)
+    *periods = period;
   return npv;
 }
 
+static double cf_view_nfv_curve(const CfView *cf, const DiscountCurve *curve,
+                                int *errorCode) {
+  int periods;
+  double npv = cf_view_npv_curve(cf, curve, &periods, errorCode);
+  if (*errorCode != ERR_NONE)
+    return 0.0;
+  return npv / curve->discount[periods];
+}
+
+double cf_npv_curve(const CashFlowList *cf, const DiscountCurve *curve,
+                    int *errorCode) {
+  CfView view = cf_view(cf);
+  return cf_view_npv_curve(&view, curve, NULL, errorCode);
+}
+
+double cf_nfv_curve(const CashFlowList *cf, const DiscountCurve *curve,
+                    int *errorCode) {
+  CfView view = cf_view(cf);
+  return cf_view_nfv_curve(&view, curve, errorCode);
+}
+
+double cf_series_npv_curve(const CashFlowSeries *series,
+                           const DiscountCurve *curve, int *errorCode) {
+  CfView view = cf_series_view(series);
+  return cf_view_npv_curve(&view, curve, NULL, errorCode);
+}
+
+double cf_series_nfv_curve(const CashFlowSeries *series,
+                           const DiscountCurve *curve, int *errorCode) {
+  CfView view = cf_series_view(series);
+  return cf_view_nfv_curve(&view, curve, errorCode);
+}
+
+int cf_npv_curve_batch(const CashFlowList projects[], int count,
+                       const DiscountCurve *curve, double npv[],
+                       int errors[]) {
+  int valued = 0;
+  for (int i = 0; i < count; i++) {
+    int errorCode;
+    CfView view = cf_view(&projects[i]);
+    npv[i] = cf_view_npv_curve(&view, curve, NULL, &errorCode);
+    if (errors)
+      errors[i] = errorCode;
+    valued += (errorCode == ERR_NONE);
+  }
+  return valued;
+}
+
 /* ============================================================
- * IRR Calculation (Newton-Raphson) - OPTIMIZED
+ * IRR Calculation (Bracketed Newton) - OPTIMIZED
  * ============================================================ */
 
+#define CF_IRR_MIN -0.999     /* Lowest rate searched (-99.9%) */
+#define CF_IRR_MAX 10.0       /* Highest rate searched (1000%) */
+#define CF_IRR_SCAN_STEPS 64  /* Grid cells for the multiple-root search */
+#define CF_IRR_SPLIT_DEPTH 6  /* Times a suspect cell may be halved */
+#define CF_IRR_GRID_SCALE 0.1 /* Grid stretch, see cf_irr_grid_t */
+#define CF_IRR_STALL 0.9      /* Newton step/last step that counts as stalled */
+
 /*
- * Compute NPV and its derivative in a single pass.
- * This halves the number of iterations through the cash flow list.
- * 
+ * Compute NPV and its derivative in a single pass over the groups.
+ *
  * Derivative: d(NPV)/dr = sum( -t * CFj / (1+r)^(t+1) )
+ *                       = -1/(1+r) * sum_groups( CFj * v^p * (p*A + B) )
  */
-static void cf_npv_and_derivative(CashFlowList *cf, double rate, 
+static void cf_npv_and_derivative(const CfView *cf, double rate,
                                    double *npv, double *dnpv) {
   *npv = cf->CF0;
   *dnpv = 0.0;
-  
-  double onePlusRate = 1.0 + rate;
+
+  double lnOnePlusRate = log1p(rate);
   double discountFactor = 1.0;
-  int period = 0;
+  double period = 0.0; /* p: periods before the current group */
 
   for (int i = 0; i < cf->count; i++) {
-    double amount = cf->flows[i].amount;
-    int freq = cf->flows[i].frequency;
-
-    for (int f = 0; f < freq; f++) {
-      period++;
-      discountFactor /= onePlusRate;
-      *npv += amount * discountFactor;
-      /* Derivative: -period * CF / (1+r)^(period+1) = -period * CF * discountFactor / (1+r) */
-      *dnpv -= (double)period * amount * discountFactor / onePlusRate;
-    }
+    double amount = cf->amount[i];
+    double vk, annuity, weighted;
+    cf_group_factors(rate, lnOnePlusRate, cf->frequency[i], &vk,
+                     &annuity, &weighted);
+
+    *npv += amount * discountFactor * annuity;
+    *dnpv -= amount * discountFactor * (period * annuity + weighted);
+
+    discountFactor *= vk;
+    period += (double)cf->frequency[i];
   }
+
+  *dnpv /= 1.0 + rate;
 }
 
-double cf_irr(CashFlowList *cf, int *errorCode) {
-  *errorCode = ERR_NONE;
+static int cf_sign(double x) { return (x > 0.0) - (x < 0.0); }
 
-  /* Check if we have any cash flows */
-  if (cf->count == 0) {
-    *errorCode = ERR_INVALID_INPUT;
-    return 0.0;
-  }
+/*
+ * With x = 1/(1+r), NPV is a polynomial in x whose coefficients are the
+ * flows in time order, and r > -1 maps onto x > 0. Descartes' rule of
+ * signs bounds the number of IRRs by the sign changes along the flows
+ * (a group repeats one amount, so it adds none).
+ *
+ * @param first Output: sign of the first non-zero flow (NPV as r -> inf)
+ * @param last Output: sign of the last non-zero flow (NPV as r -> -1)
+ */
+static int cf_sign_scan(const CfView *cf, int *first, int *last) {
+  int changes = 0;
 
-  /* Check for sign changes (necessary for IRR to exist) */
-  int hasPositive = (cf->CF0 > 0);
-  int hasNegative = (cf->CF0 < 0);
+  *first = cf_sign(cf->CF0);
+  *last = *first;
 
   for (int i = 0; i < cf->count; i++) {
-    if (cf->flows[i].amount > 0)
-      hasPositive = 1;
-    if (cf->flows[i].amount < 0)
-      hasNegative = 1;
+    int sign = cf_sign(cf->amount[i]);
+    if (sign == 0)
+      continue;
+    if (*first == 0)
+      *first = sign;
+    if (*last != 0 && sign != *last)
+      changes++;
+    *last = sign;
   }
 
-  if (!hasPositive || !hasNegative) {
-    *errorCode = ERR_NO_SOLUTION;
-    return 0.0;
-  }
+  return changes;
+}
+
+int cf_sign_changes(CashFlowList *cf) {
+  CfView view = cf_view(cf);
+  int first, last;
+  return cf_sign_scan(&view, &first, &last);
+}
 
-  /* Newton-Raphson iteration with optimized function evaluation */
-  double rate = INITIAL_GUESS;
-  double f, df;
+/*
+ * Solve NPV(rate) = 0 inside [lo, hi], where NPV has opposite signs at the
+ * two ends, starting from `rate`. A Newton step is kept whenever it lands
+ * inside the bracket, unless Newton has stalled: on the steep side NPV
+ * grows like (1+r)^-t and each step gains about the same 1/t as the one
+ * before. Otherwise the secant through the bracket ends is tried, and
+ * bisection is the last resort. Every evaluation shrinks the bracket, so
+ * the solve cannot wander off or cycle.
+ *
+ * A NaN NPV means v^t overflowed, which only happens at rates close to
+ * -100%; such a rate is treated as lying below the root.
+ */
+static double cf_irr_bracketed(const CfView *cf, double lo, double fLo,
+                               double hi, double fHi, double rate,
+                               int *evaluations, int *errorCode) {
+  double lastStep = hi - lo;
+
+  *errorCode = ERR_NONE;
 
   for (int iter = 0; iter < MAX_ITERATIONS; iter++) {
-    /* Compute NPV and derivative in single pass */
+    double f, df;
     cf_npv_and_derivative(cf, rate, &f, &df);
+    (*evaluations)++;
 
-    /* Check for convergence */
     if (fabs(f) < TOLERANCE) {
       return rate;
     }
 
-    if (fabs(df) < 1e-15) {
-      /* Derivative too small */
-      break;
+    /* Shrink the bracket around the root */
+    if (isnan(f) || cf_sign(f) == cf_sign(fLo)) {
+      lo = rate;
+      fLo = isnan(f) ? fLo : f;
+    } else {
+      hi = rate;
+      fHi = f;
     }
 
     double newRate = rate - f / df;
+    int newton = df != 0.0 && newRate > lo && newRate < hi &&
+                 fabs(newRate - rate) < CF_IRR_STALL * lastStep;
 
-    /* Bound the rate */
-    if (newRate < -0.999)
-      newRate = -0.999;
-    if (newRate > 10.0)
-      newRate = 10.0;  /* 1000% max */
+    if (!newton) {
+      double span = hi - lo;
+      newRate = 0.5 * (lo + hi);
 
-    if (fabs(newRate - rate) < TOLERANCE) {
+      /* Secant through the ends, unless it hugs one of them */
+      double secant = lo - fLo * span / (fHi - fLo);
+      if (secant > lo + 0.05 * span && secant < hi - 0.05 * span)
+        newRate = secant;
+    }
+
+    if (fabs(newRate - rate) < TOLERANCE || hi - lo < TOLERANCE) {
       return newRate;
     }
 
+    lastStep = fabs(newRate - rate);
     rate = newRate;
   }
 
-  /* Failed to converge - might have multiple IRRs */
-  *errorCode = ERR_IRR_MULTIPLE;
+  *errorCode = ERR_ITERATION;
   return 0.0;
 }
 
+/*
+ * NPV and slope at one rate of the root search grid.
+ */
+typedef struct {
+  double rate;
+  double npv;
+  double slope;
+} CfIrrPoint;
+
+static CfIrrPoint cf_irr_point(const CfView *cf, double rate,
+                               int *evaluations) {
+  CfIrrPoint point;
+  point.rate = rate;
+  cf_npv_and_derivative(cf, rate, &point.npv, &point.slope);
+  (*evaluations)++;
+  return point;
+}
+
+/*
+ * Where to start solving inside a cell with a sign change: the Newton
+ * step from whichever end is nearer zero, if it stays inside, else the
+ * middle. Starting from the flat end keeps Newton off the steep one,
+ * where NPV grows like (1+r)^-t and each step gains only about 1/t.
+ */
+static double cf_irr_cell_start(CfIrrPoint a, CfIrrPoint b) {
+  CfIrrPoint near = (fabs(a.npv) < fabs(b.npv)) ? a : b;
+
+  if (near.slope != 0.0) {
+    double rate = near.rate - near.npv / near.slope;
+    if (rate > a.rate && rate < b.rate)
+      return rate;
+  }
+  return 0.5 * (a.rate + b.rate);
+}
+
+/*
+ * Find the roots strictly inside one grid cell [a, b], in ascending order.
+ * A sign change is solved directly. Without one, NPV can still dip through
+ * zero and back inside the cell, but then the tangents at both ends reach
+ * zero inside it; only such cells are halved (at most `depth` times) to
+ * look for the dip.
+ */
+static int cf_irr_cell(const CfView *cf, CfIrrPoint a, CfIrrPoint b,
+                       int depth, double roots[], int maxRoots,
+                       int *evaluations) {
+  if (maxRoots <= 0 || isnan(a.npv) || isnan(b.npv))
+    return 0;
+
+  if (cf_sign(a.npv) * cf_sign(b.npv) < 0) {
+    int errorCode;
+    double root = cf_irr_bracketed(cf, a.rate, a.npv, b.rate, b.npv,
+                                   cf_irr_cell_start(a, b), evaluations,
+                                   &errorCode);
+    if (errorCode != ERR_NONE)
+      return 0;
+    roots[0] = root;
+    return 1;
+  }
+
+  if (depth == 0 || a.npv == 0.0 || b.npv == 0.0)
+    return 0;
+
+  double zeroA = a.rate - a.npv / a.slope;
+  double zeroB = b.rate - b.npv / b.slope;
+  if (!(zeroA > a.rate && zeroA < b.rate && zeroB > a.rate &&
+        zeroB < b.rate))
+    return 0;
+
+  CfIrrPoint mid = cf_irr_point(cf, 0.5 * (a.rate + b.rate), evaluations);
+  int found = cf_irr_cell(cf, a, mid, depth - 1, roots, maxRoots,
+                          evaluations);
+  if (mid.npv == 0.0 && found < maxRoots)
+    roots[found++] = mid.rate;
+  return found + cf_irr_cell(cf, mid, b, depth - 1, roots + found,
+                             maxRoots - found, evaluations);
+}
+
+/*
+ * The search grid is even in t, where log(1+r) = CF_IRR_GRID_SCALE *
+ * sinh(t): cells are about 1.5% wide around 0% and widen towards both
+ * limits, where IRRs are rare and NPV is steep.
+ */
+static double cf_irr_grid_t(double rate) {
+  return asinh(log1p(rate) / CF_IRR_GRID_SCALE);
+}
+
+/* Grid rate k of CF_IRR_SCAN_STEPS */
+static double cf_irr_grid_rate(int k) {
+  if (k <= 0)
+    return CF_IRR_MIN;
+  if (k >= CF_IRR_SCAN_STEPS)
+    return CF_IRR_MAX;
+
+  double tMin = cf_irr_grid_t(CF_IRR_MIN);
+  double tMax = cf_irr_grid_t(CF_IRR_MAX);
+  double t = tMin + (tMax - tMin) * (double)k / CF_IRR_SCAN_STEPS;
+  return expm1(CF_IRR_GRID_SCALE * sinh(t));
+}
+
+/* Index of the grid cell holding `rate` */
+static int cf_irr_grid_cell(double rate) {
+  double tMin = cf_irr_grid_t(CF_IRR_MIN);
+  double tMax = cf_irr_grid_t(CF_IRR_MAX);
+  return (int)((cf_irr_grid_t(rate) - tMin) / (tMax - tMin) *
+               CF_IRR_SCAN_STEPS);
+}
+
+/*
+ * Scan [CF_IRR_MIN, CF_IRR_MAX] cell by cell in ascending order. The
+ * scan stops early once `limit` roots (the Descartes bound) are known.
+ */
+static int cf_irr_scan(const CfView *cf, double roots[], int maxRoots,
+                       int limit, int *evaluations) {
+  int found = 0;
+
+  if (limit > maxRoots)
+    limit = maxRoots;
+
+  CfIrrPoint prev = cf_irr_point(cf, cf_irr_grid_rate(0), evaluations);
+  if (prev.npv == 0.0 && found < limit)
+    roots[found++] = prev.rate;
+
+  for (int k = 1; k <= CF_IRR_SCAN_STEPS && found < limit; k++) {
+    CfIrrPoint next = cf_irr_point(cf, cf_irr_grid_rate(k), evaluations);
+    found += cf_irr_cell(cf, prev, next, CF_IRR_SPLIT_DEPTH, roots + found,
+                         limit - found, evaluations);
+    if (next.npv == 0.0 && found < limit)
+      roots[found++] = next.rate;
+    prev = next;
+  }
+
+  return found;
+}
+
+/*
+ * Walk the grid outward from the cell holding `guess`, one cell at a time
+ * on each side, and stop at the first cell with a root. This finds the
+ * IRR nearest the guess without scanning the whole range.
+ */
+static int cf_irr_nearest(const CfView *cf, double guess, double *root,
+                          int *evaluations) {
+  int cell = cf_irr_grid_cell(guess);
+
+  CfIrrPoint start = cf_irr_point(cf, guess, evaluations);
+  if (start.npv == 0.0) {
+    *root = guess;
+    return 1;
+  }
+
+  /* Edges of the searched span: up[] walks right, down[] walks left */
+  CfIrrPoint up = start, down = start;
+  int nextUp = cell + 1, nextDown = cell;
+
+  while (nextUp <= CF_IRR_SCAN_STEPS || nextDown >= 0) {
+    if (nextUp <= CF_IRR_SCAN_STEPS) {
+      CfIrrPoint next =
+          cf_irr_point(cf, cf_irr_grid_rate(nextUp++), evaluations);
+      if (cf_irr_cell(cf, up, next, CF_IRR_SPLIT_DEPTH, root, 1,
+                      evaluations))
+        return 1;
+      if (next.npv == 0.0) {
+        *root = next.rate;
+        return 1;
+      }
+      up = next;
+    }
+
+    if (nextDown >= 0) {
+      CfIrrPoint next =
+          cf_irr_point(cf, cf_irr_grid_rate(nextDown--), evaluations);
+      if (cf_irr_cell(cf, next, down, CF_IRR_SPLIT_DEPTH, root, 1,
+                      evaluations))
+        return 1;
+      if (next.npv == 0.0) {
+        *root = next.rate;
+        return 1;
+      }
+      down = next;
+    }
+  }
+
+  return 0;
+}
+
+/*
+ * Discounted inflows and outflows kept apart: value[1] sums the positive
+ * flows, value[0] the magnitudes of the negative ones, and slope[] holds
+ * their derivatives in u = log(1+r).
+ */
+static void cf_npv_split(const CfView *cf, double rate, double value[2],
+                         double slope[2]) {
+  double lnOnePlusRate = log1p(rate);
+  double discountFactor = 1.0;
+  double period = 0.0;
+
+  value[0] = value[1] = 0.0;
+  slope[0] = slope[1] = 0.0;
+  value[cf->CF0 > 0.0] = fabs(cf->CF0);
+
+  for (int i = 0; i < cf->count; i++) {
+    double amount = fabs(cf->amount[i]);
+    int in = cf->amount[i] > 0.0;
+    double vk, annuity, weighted;
+    cf_group_factors(rate, lnOnePlusRate, cf->frequency[i], &vk,
+                     &annuity, &weighted);
+
+    value[in] += amount * discountFactor * annuity;
+    slope[in] -= amount * discountFactor * (period * annuity + weighted);
+
+    discountFactor *= vk;
+    period += (double)cf->frequency[i];
+  }
+}
+
+/*
+ * The single IRR of flows with one sign change. Then every outflow comes
+ * before every inflow or the other way round, so in u = log(1+r)
+ *
+ *   g(u) = log(inflows) - log(outflows)
+ *
+ * falls or rises with a slope pinned between the gaps in time separating
+ * the two sides: nearly a straight line, where NPV itself is steep near
+ * -100% and flat at high rates. Newton on g converges from any guess in
+ * a few steps; any step inside the bracket is kept, and each evaluation
+ * narrows the bracket. A limit of the searched range is only evaluated
+ * if Newton heads past it, to confirm there is a root inside at all.
+ */
+static double cf_irr_conventional(const CfView *cf, double guess,
+                                  int *evaluations, int *errorCode) {
+  double lo = log1p(CF_IRR_MIN), hi = log1p(CF_IRR_MAX);
+  int loChecked = 0, hiChecked = 0;
+  double u = log1p(guess);
+
+  *errorCode = ERR_NONE;
+
+  for (int iter = 0; iter < MAX_ITERATIONS; iter++) {
+    double value[2], slope[2];
+    double rate = expm1(u);
+    cf_npv_split(cf, rate, value, slope);
+    (*evaluations)++;
+
+    if (fabs(value[1] - value[0]) < TOLERANCE)
+      return rate;
+
+    /*
+     * Powers of (1+r) only overflow at negative rates and underflow at
+     * positive ones, far from the root; bisect towards 0% then.
+     */
+    double step = -log(value[1] / value[0]) /
+                  (slope[1] / value[1] - slope[0] / value[0]);
+    int above = isfinite(step) ? step > 0.0 : u < 0.0;
+    if (above)
+      lo = u;
+    else
+      hi = u;
+
+    double next = u + step;
+    if (!(next > lo && next < hi)) {
+      /* Heading past a limit: make sure the root is inside the range */
+      int *checked = above ? &hiChecked : &loChecked;
+      if (isfinite(step) && !*checked) {
+        *checked = 1;
+        double limit = above ? hi : lo;
+        double limitValue[2], limitSlope[2];
+        cf_npv_split(cf, expm1(limit), limitValue, limitSlope);
+        (*evaluations)++;
+        double gap = limitValue[1] - limitValue[0];
+        if (cf_sign(gap) == cf_sign(value[1] - value[0])) {
+          *errorCode = ERR_NO_SOLUTION;
+          return 0.0;
+        }
+      }
+      next = 0.5 * (lo + hi);
+    }
+
+    if (fabs(next - u) < TOLERANCE || hi - lo < TOLERANCE)
+      return expm1(next);
+    u = next;
+  }
+
+  *errorCode = ERR_ITERATION;
+  return 0.0;
+}
+
+static double cf_view_irr(const CfView *cf, double guess, int *iterations,
+                          int *errorCode) {
+  *errorCode = ERR_NONE;
+  if (iterations)
+    *iterations = 0;
+
+  /* Check if we have any cash flows */
+  if (cf->count == 0) {
+    *errorCode = ERR_INVALID_INPUT;
+    return 0.0;
+  }
+
+  /* No sign change: NPV never crosses zero */
+  int first, last;
+  int changes = cf_sign_scan(cf, &first, &last);
+  if (changes == 0) {
+    *errorCode = ERR_NO_SOLUTION;
+    return 0.0;
+  }
+
+  if (!(guess > CF_IRR_MIN && guess < CF_IRR_MAX))
+    guess = INITIAL_GUESS;
+
+  int evaluations = 0;
+  double irr = 0.0;
+
+  if (changes == 1) {
+    /* Exactly one IRR on (-1, inf) */
+    irr = cf_irr_conventional(cf, guess, &evaluations, errorCode);
+  } else {
+    /* Non-conventional flows: take the IRR closest to the guess */
+    if (!cf_irr_nearest(cf, guess, &irr, &evaluations))
+      *errorCode = ERR_NO_SOLUTION;
+  }
+
+  if (iterations)
+    *iterations = evaluations;
+  return irr;
+}
+
+double cf_irr_from(CashFlowList *cf, double guess, int *iterations,
+                   int *errorCode) {
+  CfView view = cf_view(cf);
+  double irr = cf_view_irr(&view, guess, iterations, errorCode);
+
+  if (*errorCode == ERR_NONE) {
+    cf->cache.irr = irr;
+    cf->cache.hasIrr = 1;
+  }
+  return irr;
+}
+
+/*
+ * Starting guess for cf_irr and cf_metrics. After an edit the new root is
+ * usually close to the last one, but only a unique IRR may be warm-started:
+ * with several sign changes the nearest root to the guess is returned, and
+ * that must not depend on what was solved before.
+ */
+static double cf_irr_guess(const CashFlowList *cf) {
+  CfView view = cf_view(cf);
+  int first, last;
+
+  if (cf->cache.hasIrr && cf_sign_scan(&view, &first, &last) == 1)
+    return cf->cache.irr;
+  return INITIAL_GUESS;
+}
+
+double cf_irr(CashFlowList *cf, int *errorCode) {
+  return cf_irr_from(cf, cf_irr_guess(cf), NULL, errorCode);
+}
+
+static int cf_view_irr_all(const CfView *cf, double roots[], int maxRoots,
+                           int *errorCode) {
+  *errorCode = ERR_NONE;
+
+  if (cf->count == 0) {
+    *errorCode = ERR_INVALID_INPUT;
+    return 0;
+  }
+
+  int first, last;
+  int changes = cf_sign_scan(cf, &first, &last);
+  int evaluations = 0;
+  int found = 0;
+
+  if (changes == 1 && maxRoots > 0) {
+    roots[0] = cf_irr_conventional(cf, INITIAL_GUESS, &evaluations,
+                                   errorCode);
+    found = (*errorCode == ERR_NONE);
+  } else if (changes > 1) {
+    found = cf_irr_scan(cf, roots, maxRoots, changes, &evaluations);
+  }
+
+  if (found == 0 && *errorCode == ERR_NONE)
+    *errorCode = ERR_NO_SOLUTION;
+  return found;
+}
+
+int cf_irr_all(CashFlowList *cf, double roots[], int maxRoots,
+               int *errorCode) {
+  CfView view = cf_view(cf);
+  return cf_view_irr_all(&view, roots, maxRoots, errorCode);
+}
+
+double cf_series_irr(const CashFlowSeries *series, double guess,
+                     int *iterations, int *errorCode) {
+  CfView view = cf_series_view(series);
+  return cf_view_irr(&view, guess, iterations, errorCode);
+}
+
+int cf_series_irr_all(const CashFlowSeries *series, double roots[],
+                      int maxRoots, int *errorCode) {
+  CfView view = cf_series_view(series);
+  return cf_view_irr_all(&view, roots, maxRoots, errorCode);
+}
+
 /* ============================================================
  * NFV Calculation (Pro only) - OPTIMIZED
  * ============================================================ */
 
-double cf_nfv(CashFlowList *cf, double rate) {
+static double cf_view_nfv(const CfView *cf, double rate) {
   /*
-   * NFV = NPV * (1 + r)^n
-   * 
-   * OPTIMIZED: Compute directly without separate NPV call
    * NFV = CF0*(1+r)^n + CF1*(1+r)^(n-1) + ... + CFn
+   *
+   * Compounded forward one group at a time: carrying the running value
+   * across k periods multiplies it by (1+r)^k = 1/v^k, and the group's
+   * own flows add the future value of a k-period annuity, A/v^k.
    */
+  double nfv = cf->CF0;
+  double lnOnePlusRate = log1p(rate);
+  int lastFreq = 0;
+  double vk = 1.0, annuity = 0.0;
 
-  int n = cf_total_periods(cf);
-  double onePlusRate = 1.0 + rate;
-  
-  /* Start with CF0 compounded n periods */
-  double nfv = cf->CF0 * pow(onePlusRate, (double)n);
-  
-  int periodsRemaining = n;
-  
   for (int i = 0; i < cf->count; i++) {
-    double amount = cf->flows[i].amount;
-    int freq = cf->flows[i].frequency;
-
-    for (int f = 0; f < freq; f++) {
-      periodsRemaining--;
-      /* Compound this cash flow for remaining periods */
-      nfv += amount * pow(onePlusRate, (double)periodsRemaining);
+    /* Runs of equal frequencies share one set of factors */
+    if (cf->frequency[i] != lastFreq) {
+      lastFreq = cf->frequency[i];
+      cf_group_factors(rate, lnOnePlusRate, lastFreq, &vk, &annuity, NULL);
     }
+
+    nfv = (nfv + cf->amount[i] * annuity) / vk;
   }
 
   return nfv;
 }
 
+double cf_nfv(CashFlowList *cf, double rate) {
+  CfView view = cf_view(cf);
+  return cf_view_nfv(&view, rate);
+}
+
+double cf_series_nfv(const CashFlowSeries *series, double rate) {
+  CfView view = cf_series_view(series);
+  return cf_view_nfv(&view, rate);
+}
+
 /* ============================================================
- * Payback Period (Pro only)
+ * Payback and Discounted Payback (Pro only)
  * ============================================================ */
 
-double cf_payback(CashFlowList *cf) {
-  /*
-   * Simple payback: Find when cumulative CF >= 0
-   */
+/* Value of the first j flows of a group, per unit of its first discount */
+static double cf_group_partial(double rate, double lnOnePlusRate, int j) {
+  if (rate == 0.0)
+    return (double)j;
+  return -expm1(-(double)j * lnOnePlusRate) / rate;
+}
 
+/*
+ * Periods into a group (amount > 0, worth `unit` per period before
+ * discounting within the group) at which `cumulative` reaches zero. The
+ * caller has checked that it does so within `freq` periods.
+ *
+ * Solves unit * A(j) = -cumulative for real j, takes the period j where
+ * the crossing lands, then interpolates linearly inside that period as
+ * the period-by-period scan did.
+ */
+static double cf_payback_in_group(double cumulative, double unit, double rate,
+                                  double lnOnePlusRate, int freq) {
+  double x = -cumulative / unit;
+  double real = (rate == 0.0) ? x : -log1p(-rate * x) / lnOnePlusRate;
+
+  int j = !(real > 1.0) ? 1 : (real > freq) ? freq : (int)ceil(real);
+
+  /* Rounding in the closed form can land one period off */
+  while (j > 1 &&
+         cumulative + unit * cf_group_partial(rate, lnOnePlusRate, j - 1) >= 0)
+    j--;
+  while (j < freq &&
+         cumulative + unit * cf_group_partial(rate, lnOnePlusRate, j) < 0)
+    j++;
+
+  double before =
+      cumulative + unit * cf_group_partial(rate, lnOnePlusRate, j - 1);
+  double flow = (rate == 0.0) ? unit : unit * exp(-(double)j * lnOnePlusRate);
+  return (double)(j - 1) + (-before / flow);
+}
+
+/*
+ * First time the cumulative discounted flow reaches zero, with linear
+ * interpolation inside that period; -1 if it never does. Whole groups
+ * are added as geometric sums, and only the group where the total turns
+ * non-negative is solved period-wise, so the cost is O(count) however
+ * long the runs are. Rate 0 gives the simple payback.
+ */
+static double cf_view_payback_at(const CfView *cf, double rate) {
   double cumulative = cf->CF0;
+  double discountFactor = 1.0; /* v^p: discount to the start of the group */
+  double lnOnePlusRate = log1p(rate);
   int period = 0;
 
   /* If CF0 is already positive, payback is immediate */
@@ -249,79 +1331,165 @@ double cf_payback(CashFlowList *cf) {
   }
 
   for (int i = 0; i < cf->count; i++) {
-    double amount = cf->flows[i].amount;
-    int freq = cf->flows[i].frequency;
-
-    for (int f = 0; f < freq; f++) {
-      period++;
-      double prevCumulative = cumulative;
-      cumulative += amount;
-
-      if (cumulative >= 0) {
-        /* Interpolate for fractional period */
-        if (amount > 0) {
-          double fraction = -prevCumulative / amount;
-          return (double)(period - 1) + fraction;
-        }
-        return (double)period;
-      }
+    double amount = cf->amount[i];
+    int freq = cf->frequency[i];
+    double vk, annuity;
+    cf_group_factors(rate, lnOnePlusRate, freq, &vk, &annuity, NULL);
+
+    /* Cumulative only rises inside a group of positive flows */
+    double unit = amount * discountFactor;
+    if (amount > 0 && cumulative + unit * annuity >= 0) {
+      return (double)period +
+             cf_payback_in_group(cumulative, unit, rate, lnOnePlusRate, freq);
     }
+
+    cumulative += unit * annuity;
+    discountFactor *= vk;
+    period += freq;
   }
 
   /* Never recovers */
   return -1.0;
 }
 
-/* ============================================================
- * Discounted Payback Period (Pro only) - OPTIMIZED
- * ============================================================ */
+double cf_payback(CashFlowList *cf) {
+  CfView view = cf_view(cf);
+  return cf_view_payback_at(&view, 0.0);
+}
+
+double cf_series_payback(const CashFlowSeries *series) {
+  CfView view = cf_series_view(series);
+  return cf_view_payback_at(&view, 0.0);
+}
 
 double cf_discounted_payback(CashFlowList *cf, double rate) {
-  /*
-   * Discounted payback: Find when cumulative discounted CF >= 0
-   * 
-   * OPTIMIZED: Use iterative discount factor instead of pow() each iteration
-   */
+  CfView view = cf_view(cf);
+  return cf_view_payback_at(&view, rate);
+}
 
-  double cumulative = cf->CF0;
+double cf_series_discounted_payback(const CashFlowSeries *series,
+                                    double rate) {
+  CfView view = cf_series_view(series);
+  return cf_view_payback_at(&view, rate);
+}
+
+/*
+ * cf_view_payback_at for a block of rates in one walk over the groups, as
+ * cf_view_npv_profile does for NPV: each group is read once per block,
+ * v^k comes from the shared binary powering and is only redone when the
+ * frequency changes, and a rate drops out of the walk once its payback
+ * is found. Agrees with cf_view_payback_at to about 1e-11 periods.
+ */
+static void cf_view_payback_block(const CfView *cf, const double rate[],
+                                  double out[], int m) {
+  double lnOnePlusRate[CF_PROFILE_BLOCK];
+  double discountFactor[CF_PROFILE_BLOCK];
+  double cumulative[CF_PROFILE_BLOCK];
+  double vk[CF_PROFILE_BLOCK];
+  double annuity[CF_PROFILE_BLOCK];
+  double v[CF_PROFILE_BLOCK];
+  double power[CF_PROFILE_BLOCK];
+  int live[CF_PROFILE_BLOCK];
+  int active = m;
+  int factorsFreq = 0; /* Frequency vk/annuity currently hold */
   int period = 0;
-  double discountFactor = 1.0;
-  double onePlusRate = 1.0 + rate;
 
-  if (cumulative >= 0) {
-    return 0.0;
+  /* If CF0 is already positive, payback is immediate */
+  if (cf->CF0 >= 0) {
+    for (int r = 0; r < m; r++)
+      out[r] = 0.0;
+    return;
   }
 
-  for (int i = 0; i < cf->count; i++) {
-    double amount = cf->flows[i].amount;
-    int freq = cf->flows[i].frequency;
-
-    for (int f = 0; f < freq; f++) {
-      period++;
-      discountFactor /= onePlusRate;  /* Replaces pow(1+r, period) */
-      double discountedAmount = amount * discountFactor;
-      double prevCumulative = cumulative;
-      cumulative += discountedAmount;
-
-      if (cumulative >= 0) {
-        if (discountedAmount > 0) {
-          double fraction = -prevCumulative / discountedAmount;
-          return (double)(period - 1) + fraction;
+  for (int r = 0; r < m; r++) {
+    lnOnePlusRate[r] = log1p(rate[r]);
+    v[r] = 1.0 / (1.0 + rate[r]);
+    discountFactor[r] = 1.0;
+    cumulative[r] = cf->CF0;
+    live[r] = 1;
+    out[r] = -1.0; /* Never recovers, unless found below */
+  }
+
+  for (int i = 0; i < cf->count && active > 0; i++) {
+    double amount = cf->amount[i];
+    int freq = cf->frequency[i];
+
+    if (freq != factorsFreq) {
+      /* v^k by binary powering, as in cf_view_npv_profile */
+      for (int r = 0; r < m; r++) {
+        vk[r] = 1.0;
+        power[r] = v[r];
+      }
+      for (int e = freq; e; e >>= 1) {
+        if (e & 1) {
+          for (int r = 0; r < m; r++)
+            vk[r] *= power[r];
+        }
+        if (e > 1) {
+          for (int r = 0; r < m; r++)
+            power[r] *= power[r];
         }
-        return (double)period;
       }
+      for (int r = 0; r < m; r++) {
+        if (fabs(rate[r]) * freq < CF_PROFILE_SMALL_KR)
+          cf_group_factors(rate[r], lnOnePlusRate[r], freq, &vk[r],
+                           &annuity[r], NULL);
+        else
+          annuity[r] = (1.0 - vk[r]) / rate[r];
+      }
+      factorsFreq = freq;
+    }
+
+    for (int r = 0; r < m; r++) {
+      if (!live[r])
+        continue;
+
+      /* Cumulative only rises inside a group of positive flows */
+      double unit = amount * discountFactor[r];
+      if (amount > 0 && cumulative[r] + unit * annuity[r] >= 0) {
+        out[r] = (double)period +
+                 cf_payback_in_group(cumulative[r], unit, rate[r],
+                                     lnOnePlusRate[r], freq);
+        live[r] = 0;
+        active--;
+        continue;
+      }
+
+      cumulative[r] += unit * annuity[r];
+      discountFactor[r] *= vk[r];
     }
+    period += freq;
   }
+}
 
-  return -1.0;
+static double cf_view_payback_profile(const CfView *cf, const double rates[],
+                                      double discounted[], int k) {
+  for (int base = 0; base < k; base += CF_PROFILE_BLOCK) {
+    int m = k - base < CF_PROFILE_BLOCK ? k - base : CF_PROFILE_BLOCK;
+    cf_view_payback_block(cf, rates + base, discounted + base, m);
+  }
+  return cf_view_payback_at(cf, 0.0);
+}
+
+double cf_payback_profile(CashFlowList *cf, const double rates[],
+                          double discounted[], int k) {
+  CfView view = cf_view(cf);
+  return cf_view_payback_profile(&view, rates, discounted, k);
+}
+
+double cf_series_payback_profile(const CashFlowSeries *series,
+                                 const double rates[], double discounted[],
+                                 int k) {
+  CfView view = cf_series_view(series);
+  return cf_view_payback_profile(&view, rates, discounted, k);
 }
 
 /* ============================================================
  * Modified IRR (Pro only)
  * ============================================================ */
 
-double cf_mirr(CashFlowList *cf, double financeRate, double reinvestRate,
-               int *errorCode) {
+static double cf_view_mirr(const CfView *cf, double financeRate,
+                           double reinvestRate, int *errorCode) {
   /*
    * MIRR formula:
    * MIRR = (FV of positive CFs at reinvest rate / PV of negative CFs at finance
@@ -330,37 +1498,52 @@ double cf_mirr(CashFlowList *cf, double financeRate, double reinvestRate,
 
   *errorCode = ERR_NONE;
 
-  int n = cf_total_periods(cf);
+  int n = cf_view_periods(cf);
   if (n == 0) {
     *errorCode = ERR_INVALID_INPUT;
     return 0.0;
   }
 
+  /*
+   * Both legs are summed per group with cf_group_factors: negatives are
+   * discounted to time 0 at the finance rate, positives compounded to
+   * period n at the reinvest rate the same way cf_view_nfv does it.
+   */
   double pvNegative = 0.0;
   double fvPositive = 0.0;
-  int period = 0;
+  double financeDiscount = 1.0; /* v^p at the finance rate */
+  double lnFinance = log1p(financeRate);
+  double lnReinvest = log1p(reinvestRate);
+  int lastFreq = 0;
+  double financeVk = 1.0, financeAnnuity = 0.0;
+  double reinvestVk = 1.0, reinvestAnnuity = 0.0;
 
   /* Handle CF0 */
   if (cf->CF0 < 0) {
     pvNegative += -cf->CF0; /* Make positive for calculation */
   } else {
-    fvPositive += cf->CF0 * pow(1.0 + reinvestRate, (double)n);
+    fvPositive += cf->CF0;
   }
 
-  /* Process each cash flow */
+  /* Process each cash flow group */
   for (int i = 0; i < cf->count; i++) {
-    double amount = cf->flows[i].amount;
-    int freq = cf->flows[i].frequency;
+    double amount = cf->amount[i];
+
+    if (cf->frequency[i] != lastFreq) {
+      lastFreq = cf->frequency[i];
+      cf_group_factors(financeRate, lnFinance, lastFreq, &financeVk,
+                       &financeAnnuity, NULL);
+      cf_group_factors(reinvestRate, lnReinvest, lastFreq, &reinvestVk,
+                       &reinvestAnnuity, NULL);
+    }
 
-    for (int f = 0; f < freq; f++) {
-      period++;
+    if (amount < 0)
+      pvNegative += -amount * financeDiscount * financeAnnuity;
+    else
+      fvPositive += amount * reinvestAnnuity;
 
-      if (amount < 0) {
-        pvNegative += -amount / pow(1.0 + financeRate, (double)period);
-      } else {
-        fvPositive += amount * pow(1.0 + reinvestRate, (double)(n - period));
-      }
-    }
+    financeDiscount *= financeVk;
+    fvPositive /= reinvestVk;
   }
 
   if (pvNegative == 0.0) {
@@ -368,5 +1551,49 @@ double cf_mirr(CashFlowList *cf, double financeRate, double reinvestRate,
     return 0.0;
   }
 
-  return pow(fvPositive / pvNegative, 1.0 / (double)n) - 1.0;
+  return fin_powm1(fvPositive / pvNegative - 1.0, 1.0 / (double)n);
+}
+
+double cf_mirr(CashFlowList *cf, double financeRate, double reinvestRate,
+               int *errorCode) {
+  CfView view = cf_view(cf);
+  return cf_view_mirr(&view, financeRate, reinvestRate, errorCode);
+}
+
+double cf_series_mirr(const CashFlowSeries *series, double financeRate,
+                      double reinvestRate, int *errorCode) {
+  CfView view = cf_series_view(series);
+  return cf_view_mirr(&view, financeRate, reinvestRate, errorCode);
+}
+
+/* ============================================================
+ * Project Metrics
+ * ============================================================ */
+
+static int cf_view_metrics(const CfView *cf, double rate, double financeRate,
+                           double reinvestRate, double guess,
+                           CashFlowMetrics *out) {
+  out->npv = cf_npv_at(cf, rate);
+  out->irr = cf_view_irr(cf, guess, NULL, &out->irrError);
+  out->mirr = cf_view_mirr(cf, financeRate, reinvestRate, &out->mirrError);
+  out->payback = cf_view_payback_at(cf, 0.0);
+  out->discountedPayback = cf_view_payback_at(cf, rate);
+
+  return out->irrError != ERR_NONE ? out->irrError : out->mirrError;
+}
+
+int cf_metrics(const CashFlowList *cf, double rate, double financeRate,
+               double reinvestRate, CashFlowMetrics *out) {
+  CfView view = cf_view(cf);
+  /* The last IRR is only read, never stored back */
+  return cf_view_metrics(&view, rate, financeRate, reinvestRate,
+                         cf_irr_guess(cf), out);
+}
+
+int cf_series_metrics(const CashFlowSeries *series, double rate,
+                      double financeRate, double reinvestRate,
+                      CashFlowMetrics *out) {
+  CfView view = cf_series_view(series);
+  return cf_view_metrics(&view, rate, financeRate, reinvestRate,
+                         INITIAL_GUESS, out);
 }
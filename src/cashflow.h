@@ -7,6 +7,67 @@
 #define CASHFLOW_H
 
 #include "types.h"
+#include <stddef.h>
+
+/* ============================================================
+ * Arena-Backed Series
+ * ============================================================ */
+
+/**
+ * Caller-supplied memory that series carve their arrays from. Nothing is
+ * freed individually; cf_arena_reset releases every series built on it.
+ */
+typedef struct {
+  unsigned char *base; /* Start of the caller's buffer */
+  size_t size;         /* Buffer size in bytes */
+  size_t used;         /* Bytes handed out so far */
+} CashFlowArena;
+
+/**
+ * Cash flow list of any length (e.g. thousands of monthly groups), laid
+ * out as parallel amount[]/frequency[] arrays inside an arena. Uses the
+ * same kernels as CashFlowList; CF0 may be assigned directly.
+ */
+typedef struct {
+  double CF0;           /* Initial cash flow */
+  double *amount;       /* Cj: amount of group j */
+  int *frequency;       /* Fj: times group j repeats */
+  int count;            /* Number of cash flow groups */
+  int capacity;         /* Groups that fit before the arrays must grow */
+  CashFlowArena *arena; /* Where the arrays live */
+} CashFlowSeries;
+
+/**
+ * Discount factors for periods 0..periods, with their running sums, so
+ * NPV against the curve needs no compounding. Built once (into an arena)
+ * and shared read-only by every project valued against it.
+ */
+typedef struct {
+  double *discount;   /* D(p): value today of 1 paid at period p; D(0) = 1 */
+  double *cumulative; /* D(1) + ... + D(p); cumulative[0] = 0 */
+  int periods;        /* Last period the curve covers */
+} DiscountCurve;
+
+/**
+ * How cf_curve_from_zeros fills periods between tenor knots
+ */
+typedef enum {
+  CURVE_LINEAR_ZERO,        /* Zero rate linear in time */
+  CURVE_LOG_LINEAR_DISCOUNT /* log D linear in time (flat forwards) */
+} CurveInterpolation;
+
+/**
+ * Every screening measure of one project, as filled in by cf_metrics
+ */
+typedef struct {
+  double npv;               /* NPV at the discount rate */
+  double irr;               /* IRR as decimal (0 when irrError is set) */
+  double mirr;              /* MIRR as decimal (0 when mirrError is set) */
+  double payback;           /* Periods, or -1 if never recovered */
+  double discountedPayback; /* Periods at the discount rate, or -1 */
+  int irrError;             /* ERR_* from the IRR solve */
+  int mirrError;            /* ERR_* from MIRR */
+} CashFlowMetrics;
 
 /* ============================================================
  * Cash Flow List Management
@@ -32,6 +93,8 @@ int cf_add(CashFlowList *cf, double amount, int frequency);
 
 /**
  * Update an existing cash flow
+ * An amount change keeps cf_npv's cached rate current in O(1); a
+ * frequency change re-discounts every group at that rate.
  * @param index Index of the cash flow (0-based, not including CF0)
  */
 void cf_update(CashFlowList *cf, int index, double amount, int frequency);
@@ -46,26 +109,117 @@ void cf_delete(CashFlowList *cf, int index);
  */
 int cf_total_periods(CashFlowList *cf);
 
+/* ============================================================
+ * Series Management
+ * ============================================================ */
+
+/**
+ * Point an arena at a caller buffer (static, stack or heap)
+ */
+void cf_arena_init(CashFlowArena *arena, void *buffer, size_t size);
+
+/**
+ * Release everything carved from the arena; series built on it become
+ * invalid and must be initialized again
+ */
+void cf_arena_reset(CashFlowArena *arena);
+
+/**
+ * Initialize an empty series with room for `capacity` groups
+ * @return 1 on success, 0 if the arena is too small
+ */
+int cf_series_init(CashFlowSeries *series, CashFlowArena *arena,
+                   int capacity);
+
+/**
+ * Append a group, doubling the arrays inside the arena when full
+ * (in place when the series holds the arena's newest block)
+ * @return Index of the added group, or -1 if the arena is exhausted
+ */
+int cf_series_add(CashFlowSeries *series, double amount, int frequency);
+
+/**
+ * Total number of periods across all groups
+ */
+int cf_series_total_periods(const CashFlowSeries *series);
+
 /* ============================================================
  * NPV / IRR / NFV Calculations
  * ============================================================ */
 
 /**
  * Calculate Net Present Value
+ * Each flow group is summed in closed form, so the cost is O(count)
+ * regardless of frequencies. The per-group values are kept at this rate,
+ * so asking again at the same rate after cf_set_cf0/cf_add or an
+ * amount-only cf_update costs O(1).
  * @param cf Cash flow list
- * @param rate Discount rate per period (not %)
+ * @param rate Discount rate per period (not %, must be > -1)
  * @return NPV
  */
 double cf_npv(CashFlowList *cf, double rate);
 
 /**
- * Calculate Internal Rate of Return using Newton-Raphson
+ * NPV at k rates in one pass over the flows, e.g. for an NPV-vs-rate
+ * plot or to locate the crossover rate of two projects. Each out[i]
+ * agrees with cf_npv(cf, rates[i]) to rounding; the cf_npv cache is left
+ * untouched.
+ * @param rates Discount rates per period (decimals, each > -1)
+ * @param out Output: k NPVs
+ */
+void cf_npv_profile(CashFlowList *cf, const double rates[], double out[],
+                    int k);
+
+/**
+ * Count sign changes along CF0, CF1, ... (zero flows skipped).
+ * By Descartes' rule of signs this bounds the number of IRRs.
+ */
+int cf_sign_changes(CashFlowList *cf);
+
+/**
+ * Calculate Internal Rate of Return
+ * Same as cf_irr_from, warm-started from this list's last IRR when the
+ * flows have one sign change; otherwise (and the first time) from
+ * INITIAL_GUESS, so a non-conventional project always reports the same
+ * root.
  * @param cf Cash flow list
  * @param errorCode Output: set to non-zero if no solution
  * @return IRR as decimal (multiply by 100 for %)
  */
 double cf_irr(CashFlowList *cf, int *errorCode);
 
+/**
+ * Calculate IRR, warm-started from a previous rate.
+ *
+ * With one sign change the IRR is unique in (-99.9%, 1000%) and is
+ * solved by bracketed Newton steps on log(inflows / outflows), which is
+ * close to linear in log(1+r). With more, the search walks outward from
+ * the guess and returns the nearest IRR (see cf_irr_all for all of
+ * them). A converged IRR is remembered as the list's warm start for
+ * cf_irr.
+ *
+ * @param guess Starting rate (decimal); ignored unless within the range
+ * @param iterations Output: NPV evaluations used (may be NULL)
+ * @param errorCode Output: ERR_NO_SOLUTION if no IRR lies in the range,
+ *                  ERR_INVALID_INPUT if there are no flows
+ * @return IRR as decimal
+ */
+double cf_irr_from(CashFlowList *cf, double guess, int *iterations,
+                   int *errorCode);
+
+/**
+ * Find every IRR between -99.9% and 1000%, in ascending order.
+ * At most cf_sign_changes(cf) roots exist, and the search stops once that
+ * many are found. A root where NPV only touches zero is not reported.
+ *
+ * @param roots Output: IRRs as decimals
+ * @param maxRoots Capacity of roots
+ * @param errorCode Output: ERR_NO_SOLUTION if none is found
+ * @return Number of roots written
+ */
+int cf_irr_all(CashFlowList *cf, double roots[], int maxRoots,
+               int *errorCode);
+
 /**
  * Calculate Net Future Value (Pro only)
  * NFV = NPV * (1 + rate)^n
@@ -74,15 +228,30 @@ double cf_nfv(CashFlowList *cf, double rate);
 
 /**
  * Calculate Payback Period (Pro only)
- * Number of periods to recover initial investment
+ * Number of periods to recover initial investment, interpolated within
+ * the period where the cumulative flow turns non-negative. Whole groups
+ * are skipped in O(1), so the cost is O(count) regardless of frequencies.
+ * @return Periods, or -1 if the investment is never recovered
  */
 double cf_payback(CashFlowList *cf);
 
 /**
  * Calculate Discounted Payback Period (Pro only)
+ * As cf_payback on flows discounted at `rate`
+ * @return Periods, or -1 if never recovered
  */
 double cf_discounted_payback(CashFlowList *cf, double rate);
 
+/**
+ * Payback, plus the discounted payback at each of k rates, walking the
+ * groups once per block of rates as cf_npv_profile does
+ * @param rates Discount rates per period (decimals, each > -1)
+ * @param discounted Output: k discounted paybacks (-1 where never)
+ * @return Simple payback (as cf_payback)
+ */
+double cf_payback_profile(CashFlowList *cf, const double rates[],
+                          double discounted[], int k);
+
 /**
  * Calculate Modified IRR (Pro only)
  * @param financeRate Rate for negative cash flows
@@ -91,4 +260,155 @@ double cf_discounted_payback(CashFlowList *cf, double rate);
 double cf_mirr(CashFlowList *cf, double financeRate, double reinvestRate,
                int *errorCode);
 
+/* ============================================================
+ * Term-Structure Discounting
+ * ============================================================ */
+
+/**
+ * Build a curve from one rate per period: rates[p] discounts period p+1
+ * back to period p, so D(p) = 1 / ((1+rates[0]) ... (1+rates[p-1])).
+ * @param rates `periods` decimals, each > -1
+ * @return ERR_NONE, ERR_INVALID_INPUT for a rate <= -1, or ERR_OVERFLOW
+ *         if the arena is too small
+ */
+int cf_curve_from_rates(DiscountCurve *curve, CashFlowArena *arena,
+                        const double rates[], int periods);
+
+/**
+ * Build a curve from zero rates at tenor knots: D(t) = (1 + z(t))^-t,
+ * with z interpolated between knots and held flat outside them.
+ * @param tenors Knot times in periods, strictly increasing and > 0
+ * @param zeros Zero rate per period at each knot (decimals, > -1)
+ * @param knots Number of knots (at least 1)
+ * @param periods Last period to tabulate
+ * @return ERR_NONE, ERR_INVALID_INPUT for bad knots, or ERR_OVERFLOW if
+ *         the arena is too small
+ */
+int cf_curve_from_zeros(DiscountCurve *curve, CashFlowArena *arena,
+                        const double tenors[], const double zeros[],
+                        int knots, CurveInterpolation interpolation,
+                        int periods);
+
+/**
+ * NPV against a curve: per group, amount times a difference of the
+ * curve's running sums, so O(count) with no pow/exp.
+ * @param errorCode Output: ERR_INVALID_INPUT if the flows run past the
+ *                  end of the curve
+ */
+double cf_npv_curve(const CashFlowList *cf, const DiscountCurve *curve,
+                    int *errorCode);
+
+/**
+ * NFV against a curve: NPV / D(n), n = total periods
+ */
+double cf_nfv_curve(const CashFlowList *cf, const DiscountCurve *curve,
+                    int *errorCode);
+
+/**
+ * cf_npv_curve for every project in an array
+ * @param npv Output: one NPV per project
+ * @param errors Output: per-project ERR_* code (may be NULL)
+ * @return Number of projects valued without error
+ */
+int cf_npv_curve_batch(const CashFlowList projects[], int count,
+                       const DiscountCurve *curve, double npv[],
+                       int errors[]);
+
+/* ============================================================
+ * Series Calculations
+ * Same results as the CashFlowList functions of the same name.
+ * The series carries no discounting cache. Its arrays stay in the
+ * caller's arena; these functions only read them and allocate nothing.
+ * ============================================================ */
+
+/**
+ * NPV of a series, as cf_npv
+ */
+double cf_series_npv(const CashFlowSeries *series, double rate);
+
+/**
+ * IRR of a series, as cf_irr_from (guess outside the range uses
+ * INITIAL_GUESS)
+ */
+double cf_series_irr(const CashFlowSeries *series, double guess,
+                     int *iterations, int *errorCode);
+
+/**
+ * NPV at each of k rates, as cf_npv_profile
+ */
+void cf_series_npv_profile(const CashFlowSeries *series, const double rates[],
+                           double out[], int k);
+
+/**
+ * Every IRR of a series, as cf_irr_all
+ */
+int cf_series_irr_all(const CashFlowSeries *series, double roots[],
+                      int maxRoots, int *errorCode);
+
+/**
+ * NFV of a series, as cf_nfv
+ */
+double cf_series_nfv(const CashFlowSeries *series, double rate);
+
+/**
+ * Payback of a series, as cf_payback
+ */
+double cf_series_payback(const CashFlowSeries *series);
+
+/**
+ * Discounted payback of a series, as cf_discounted_payback
+ */
+double cf_series_discounted_payback(const CashFlowSeries *series,
+                                    double rate);
+
+/**
+ * Payback and k discounted paybacks, as cf_payback_profile
+ */
+double cf_series_payback_profile(const CashFlowSeries *series,
+                                 const double rates[], double discounted[],
+                                 int k);
+
+/**
+ * MIRR of a series, as cf_mirr
+ */
+double cf_series_mirr(const CashFlowSeries *series, double financeRate,
+                      double reinvestRate, int *errorCode);
+
+/**
+ * NPV against a zero curve, as cf_npv_curve
+ */
+double cf_series_npv_curve(const CashFlowSeries *series,
+                           const DiscountCurve *curve, int *errorCode);
+
+/**
+ * NFV against a zero curve, as cf_nfv_curve
+ */
+double cf_series_nfv_curve(const CashFlowSeries *series,
+                           const DiscountCurve *curve, int *errorCode);
+
+/* ============================================================
+ * Project Metrics
+ * ============================================================ */
+
+/**
+ * NPV, IRR, MIRR, payback and discounted payback of one project.
+ * Reads the list only (the IRR starts as in cf_irr, but the result is
+ * not stored back), so different threads may evaluate
+ * different lists at once.
+ * @param rate Discount rate for NPV and discounted payback (decimal)
+ * @param financeRate MIRR rate for negative cash flows (decimal)
+ * @param reinvestRate MIRR rate for positive cash flows (decimal)
+ * @param out Output: the metrics and their individual error codes
+ * @return out->irrError if set, else out->mirrError (ERR_NONE if both ok)
+ */
+int cf_metrics(const CashFlowList *cf, double rate, double financeRate,
+               double reinvestRate, CashFlowMetrics *out);
+
+/**
+ * cf_metrics for a series (the IRR starts from INITIAL_GUESS)
+ */
+int cf_series_metrics(const CashFlowSeries *series, double rate,
+                      double financeRate, double reinvestRate,
+                      CashFlowMetrics *out);
+
 #endif /* CASHFLOW_H */
@@ -61,23 +61,45 @@ int date_is_valid(Date *d) {
  * Days Since Epoch Conversion
  * ============================================================ */
 
-long date_to_days_since_epoch(Date *d) {
-  long days = 0;
+/*
+ * Civil date <-> day number in O(1) (H. Hinnant's days_from_civil /
+ * civil_from_days). Years are shifted to start on March 1 so the leap
+ * day falls at the end, which turns the month lengths into the linear
+ * formula (153*m + 2) / 5 and the leap rules into plain divisions of the
+ * year-of-era.
+ *
+ * Internally days are counted from 0000-03-01; EPOCH_DAY_OFFSET moves
+ * that so January 1, 1900 is day 1.
+ */
+#define DAYS_PER_ERA 146097L /* Days in a 400-year Gregorian cycle */
+#define EPOCH_DAY_OFFSET 693900L
 
-  /* Add days for complete years */
-  for (int y = EPOCH_YEAR; y < d->year; y++) {
-    days += date_is_leap_year(y) ? 366 : 365;
-  }
+long date_days_from_civil(int year, int month, int day) {
+  long y = (long)year - (month <= 2);
+  long era = (y >= 0 ? y : y - 399) / 400;
+  long yoe = y - era * 400;                                   /* [0, 399] */
+  long doy = (153L * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+  long doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;           /* [0, 146096] */
 
-  /* Add days for complete months in current year */
-  for (int m = 1; m < d->month; m++) {
-    days += date_days_in_month(m, d->year);
-  }
+  return era * DAYS_PER_ERA + doe - EPOCH_DAY_OFFSET;
+}
 
-  /* Add days in current month */
-  days += d->day;
+void date_civil_from_days(long days, Date *result) {
+  long z = days + EPOCH_DAY_OFFSET;
+  long era = (z >= 0 ? z : z - (DAYS_PER_ERA - 1)) / DAYS_PER_ERA;
+  long doe = z - era * DAYS_PER_ERA;
+  long yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+  long doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+  long mp = (5 * doy + 2) / 153;
+  int month = (int)(mp < 10 ? mp + 3 : mp - 9);
 
-  return days;
+  result->day = (int)(doy - (153 * mp + 2) / 5 + 1);
+  result->month = month;
+  result->year = (int)(yoe + era * 400 + (month <= 2));
+}
+
+long date_to_days_since_epoch(Date *d) {
+  return date_days_from_civil(d->year, d->month, d->day);
 }
 
 void date_from_days_since_epoch(long days, Date *result) {
@@ -88,30 +110,7 @@ void date_from_days_since_epoch(long days, Date *result) {
     return;
   }
 
-  int year = EPOCH_YEAR;
-
-  /* Find the year */
-  while (1) {
-    int daysInYear = date_is_leap_year(year) ? 366 : 365;
-    if (days <= daysInYear)
-      break;
-    days -= daysInYear;
-    year++;
-  }
-
-  /* Find the month */
-  int month = 1;
-  while (month <= 12) {
-    int daysInMonth = date_days_in_month(month, year);
-    if (days <= daysInMonth)
-      break;
-    days -= daysInMonth;
-    month++;
-  }
-
-  result->year = year;
-  result->month = month;
-  result->day = (int)days;
+  date_civil_from_days(days, result);
 }
 
 /* ============================================================
@@ -89,6 +89,17 @@ int date_day_of_week(Date *d);
  */
 const char *date_day_name(int dayOfWeek);
 
+/**
+ * Convert a civil date to a day number in O(1) (no year/month loops).
+ * Day 1 is January 1, 1900; earlier dates give values <= 0.
+ */
+long date_days_from_civil(int year, int month, int day);
+
+/**
+ * Convert a day number from date_days_from_civil() back to a civil date.
+ */
+void date_civil_from_days(long days, Date *result);
+
 /**
  * Convert date to days since epoch (for internal calculations).
  * Epoch: January 1, 1900
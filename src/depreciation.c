@@ -13,6 +13,7 @@
 
 #include "depreciation.h"
 #include <math.h>
+#include <stddef.h>
 
 /* ============================================================
  * Method Names
@@ -244,19 +245,26 @@ double depr_dbf(double cost, double salvage, double life, int startMonth,
 }
 
 /* ============================================================
- * Main Depreciation Calculator
+ * Schedule Engine
  * ============================================================ */
-DepreciationResult depr_calculate(DepreciationInput *input,
-                                  DepreciationMethod method, int year) {
-  DepreciationResult result = {0};
 
-  if (!input || year < 1)
-    return result;
+/*
+ * Walks years 1..lastYear once, carrying each method's book value forward
+ * instead of restarting from year 1 for every year. The per-year values
+ * and the accumulation order are exactly those of the single-year
+ * functions above, so results match them bit for bit.
+ *
+ * Rows go to rows[0..maxRows-1] when given; the row for lastYear is
+ * returned either way.
+ */
+static DepreciationResult depr_walk(const DepreciationInput *input,
+                                    DepreciationMethod method, int lastYear,
+                                    DepreciationResult rows[], int maxRows) {
+  DepreciationResult row = {0};
 
   double cost = input->cost;
   double salvage = input->salvage;
   double life = input->life;
-  double dbRate = input->dbRate;
   int startMonth = input->startMonth;
 
   if (startMonth < 1)
@@ -264,40 +272,18 @@ DepreciationResult depr_calculate(DepreciationInput *input,
   if (startMonth > 12)
     startMonth = 12;
 
-  result.year = year;
-  result.bookValueStart = cost;
-
-  /* Calculate depreciation based on method */
-  switch (method) {
-  case DEPR_SL:
-    result.depreciation = depr_straight_line(cost, salvage, life);
-    break;
-  case DEPR_SYD:
-    result.depreciation = depr_syd(cost, salvage, life, year);
-    break;
-  case DEPR_DB:
-    result.depreciation = depr_db(cost, salvage, life, dbRate, year);
-    break;
-  case DEPR_DB_SL:
-    result.depreciation = depr_db_sl(cost, salvage, life, dbRate, year);
-    break;
-  case DEPR_SLF:
-    result.depreciation = depr_slf(cost, salvage, life, startMonth, year);
-    break;
-  case DEPR_DBF:
-    result.depreciation = depr_dbf(cost, salvage, life, startMonth, year);
-    break;
-  default:
-    result.depreciation = 0.0;
-    break;
-  }
+  /* Per-method carried state */
+  double dbRate = (life > 0) ? input->dbRate / 100.0 / life : 0.0;
+  double dbfRate = (life > 0) ? french_db_coefficient(life) / life : 0.0;
+  double methodBook = cost; /* Book value as the method itself tracks it */
+  int dbFloored = 0;        /* DB: book value has reached salvage */
 
-  /* Calculate accumulated depreciation and book value */
-  result.accumDepr = 0.0;
+  /* Running totals, as depr_calculate has always accumulated them */
+  double accumDepr = 0.0;
   double bookValue = cost;
 
-  for (int y = 1; y <= year; y++) {
-    double yearDep;
+  for (int y = 1; y <= lastYear; y++) {
+    double yearDep = 0.0;
 
     switch (method) {
     case DEPR_SL:
@@ -306,42 +292,111 @@ DepreciationResult depr_calculate(DepreciationInput *input,
     case DEPR_SYD:
       yearDep = depr_syd(cost, salvage, life, y);
       break;
-    case DEPR_DB:
-      yearDep = depr_db(cost, salvage, life, dbRate, y);
-      break;
-    case DEPR_DB_SL:
-      yearDep = depr_db_sl(cost, salvage, life, dbRate, y);
-      break;
     case DEPR_SLF:
       yearDep = depr_slf(cost, salvage, life, startMonth, y);
       break;
-    case DEPR_DBF:
-      yearDep = depr_dbf(cost, salvage, life, startMonth, y);
+    case DEPR_DB:
+      if (life <= 0)
+        break;
+      yearDep = methodBook * dbRate;
+      if (methodBook - yearDep < salvage)
+        yearDep = methodBook - salvage;
+      if (yearDep < 0)
+        yearDep = 0;
+
+      /* Advance the way depr_db's inner loop does */
+      if (!dbFloored) {
+        methodBook -= methodBook * dbRate;
+        if (methodBook < salvage) {
+          methodBook = salvage;
+          dbFloored = 1;
+        }
+      }
+      break;
+    case DEPR_DB_SL:
+    case DEPR_DBF: {
+      if (life <= 0)
+        break;
+      double factor = 1.0;
+      double rate = dbRate;
+      if (method == DEPR_DBF) {
+        factor = depr_partial_year_factor(startMonth, y, life);
+        rate = dbfRate;
+      }
+      double remainingLife = life - (double)y + 1.0;
+      double dbDep = methodBook * rate * factor;
+      double slDep = (methodBook - salvage) / remainingLife * factor;
+
+      yearDep = (slDep > dbDep) ? slDep : dbDep;
+      if (methodBook - yearDep < salvage)
+        yearDep = methodBook - salvage;
+      if (yearDep < 0)
+        yearDep = 0;
+
+      methodBook -= yearDep;
       break;
+    }
     default:
-      yearDep = 0.0;
       break;
     }
 
-    if (y == year) {
-      result.bookValueStart = bookValue;
-    }
+    row.year = y;
+    row.depreciation = yearDep;
+    row.bookValueStart = bookValue;
 
-    result.accumDepr += yearDep;
+    accumDepr += yearDep;
     bookValue -= yearDep;
-  }
 
-  result.bookValueEnd = bookValue;
+    row.accumDepr = accumDepr;
+    row.bookValueEnd = (bookValue < salvage) ? salvage : bookValue;
+    row.remainingDepr = row.bookValueEnd - salvage;
+    if (row.remainingDepr < 0)
+      row.remainingDepr = 0;
 
-  /* Ensure book value doesn't go below salvage */
-  if (result.bookValueEnd < salvage) {
-    result.bookValueEnd = salvage;
+    if (rows && y <= maxRows)
+      rows[y - 1] = row;
   }
 
-  /* Remaining depreciable amount */
-  result.remainingDepr = result.bookValueEnd - salvage;
-  if (result.remainingDepr < 0)
-    result.remainingDepr = 0;
+  return row;
+}
+
+int depr_schedule_years(const DepreciationInput *input,
+                        DepreciationMethod method) {
+  if (!input || input->life <= 0)
+    return 0;
+
+  int years = (int)ceil(input->life);
+
+  /* French methods prorate the first year and run into one extra year */
+  if ((method == DEPR_SLF || method == DEPR_DBF) && input->startMonth > 1)
+    years++;
+
+  return years;
+}
+
+int depr_schedule(const DepreciationInput *input, DepreciationMethod method,
+                  DepreciationResult rows[], int maxRows) {
+  if (!input || !rows || maxRows <= 0)
+    return 0;
+
+  int years = depr_schedule_years(input, method);
+  if (years > maxRows)
+    years = maxRows;
+
+  depr_walk(input, method, years, rows, years);
+  return years;
+}
+
+/* ============================================================
+ * Main Depreciation Calculator
+ * ============================================================ */
+DepreciationResult depr_calculate(DepreciationInput *input,
+                                  DepreciationMethod method, int year) {
+  DepreciationResult result = {0};
+
+  if (!input || year < 1)
+    return result;
 
-  return result;
+  /* The requested year's row of a schedule walked once to that year */
+  return depr_walk(input, method, year, NULL, 0);
 }
@@ -58,10 +58,33 @@ typedef struct {
 /**
  * Calculate depreciation for a specific year.
  * Handles partial year for first and last year automatically.
+ * Walks the schedule once up to the year, so the cost is O(year).
  */
 DepreciationResult depr_calculate(DepreciationInput *input,
                                   DepreciationMethod method, int year);
 
+/**
+ * Number of years in an asset's schedule: ceil(life), plus one for the
+ * French methods when the first year is partial.
+ */
+int depr_schedule_years(const DepreciationInput *input,
+                        DepreciationMethod method);
+
+/**
+ * Generate the full depreciation schedule in one pass.
+ *
+ * Book value is walked forward once, so the whole schedule costs
+ * O(life); rows[k] is year k + 1 and equals depr_calculate for that year.
+ *
+ * @param input Asset parameters
+ * @param method Depreciation method
+ * @param rows Output: one row per year
+ * @param maxRows Capacity of rows
+ * @return Number of rows written (depr_schedule_years, capped at maxRows)
+ */
+int depr_schedule(const DepreciationInput *input, DepreciationMethod method,
+                  DepreciationResult rows[], int maxRows);
+
 /**
  * Get the name of a depreciation method.
  */
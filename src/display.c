@@ -430,10 +430,10 @@ void display_update_cf(DisplayState *state, Calculator *calc, int cfIndex,
   } else {
     if (isFreq) {
       snprintf(label, sizeof(label), "F%02d", cfIndex);
-      state->varValue = (double)calc->cashflow.flows[cfIndex - 1].frequency;
+      state->varValue = (double)calc->cashflow.frequency[cfIndex - 1];
     } else {
       snprintf(label, sizeof(label), "C%02d", cfIndex);
-      state->varValue = calc->cashflow.flows[cfIndex - 1].amount;
+      state->varValue = calc->cashflow.amount[cfIndex - 1];
     }
     strcpy(state->varLabel, label);
   }
@@ -0,0 +1,68 @@
+/**
+ * Open fx-BA: TI BA II Plus Clone
+ * finmath.c - Shared compounding powers
+ */
+
+#include "finmath.h"
+#include <math.h>
+
+#ifdef TEST_BUILD
+/* Per thread, so the threaded portfolio code never shares a counter */
+static _Thread_local FinPowCounts finCounts;
+#define FIN_COUNT(field) (finCounts.field++)
+#else
+#define FIN_COUNT(field) ((void)0)
+#endif
+
+/* Exponent as a whole number, or -1 if n is fractional or too large */
+static long fin_whole_exponent(double n) {
+  double magnitude = fabs(n);
+  if (magnitude > FIN_POWI_MAX || magnitude != floor(magnitude))
+    return -1;
+  return (long)magnitude;
+}
+
+/* base^k for k >= 0 by repeated squaring */
+static double fin_square_multiply(double base, long k) {
+  double result = 1.0;
+  while (k > 0) {
+    if (k & 1)
+      result *= base;
+    base *= base;
+    k >>= 1;
+  }
+  return result;
+}
+
+double fin_powi(double rate, double n) {
+  long k = fin_whole_exponent(n);
+
+  if (k < 0) {
+    FIN_COUNT(transcendental);
+    return exp(n * log1p(rate));
+  }
+
+  FIN_COUNT(binary);
+  double power = fin_square_multiply(1.0 + rate, k);
+  return (n < 0) ? 1.0 / power : power;
+}
+
+double fin_powm1(double rate, double n) {
+  /* Below this |n * rate|, x^n - 1 would lose digits to cancellation */
+  if (fabs(n * rate) < 1e-3 || fin_whole_exponent(n) < 0) {
+    FIN_COUNT(transcendental);
+    return expm1(n * log1p(rate));
+  }
+
+  return fin_powi(rate, n) - 1.0;
+}
+
+#ifdef TEST_BUILD
+void fin_pow_counts(FinPowCounts *out, int reset) {
+  *out = finCounts;
+  if (reset) {
+    finCounts.binary = 0;
+    finCounts.transcendental = 0;
+  }
+}
+#endif
@@ -0,0 +1,60 @@
+/**
+ * Open fx-BA: TI BA II Plus Clone
+ * finmath.h - Shared compounding powers
+ *
+ * The SH4 targets have no FPU, so every libm pow() is a long soft-float
+ * routine. Compounding factors (1 + i)^n almost always have a whole
+ * number of periods, which binary exponentiation handles in about
+ * 2*log2(n) multiplications.
+ */
+
+#ifndef FINMATH_H
+#define FINMATH_H
+
+/* ============================================================
+ * Limits
+ * ============================================================ */
+
+/*
+ * Largest |n| taken by repeated squaring. Rounding grows by up to one
+ * ulp per period, so past this a single exp/log1p is more accurate.
+ */
+#define FIN_POWI_MAX 1024
+
+/* ============================================================
+ * Compounding Powers
+ * ============================================================ */
+
+/**
+ * (1 + rate)^n
+ *
+ * Integral n with |n| <= FIN_POWI_MAX uses binary exponentiation;
+ * anything else is exp(n * log1p(rate)), which keeps small rates exact.
+ * @param rate Periodic rate (decimal, > -1)
+ * @param n Number of periods (any sign, need not be whole)
+ */
+double fin_powi(double rate, double n);
+
+/**
+ * (1 + rate)^n - 1, without the cancellation of fin_powi() - 1 when
+ * n * rate is small (e.g. annuity factors at low rates)
+ */
+double fin_powm1(double rate, double n);
+
+#ifdef TEST_BUILD
+/* ============================================================
+ * Call Counting (host builds only)
+ * ============================================================ */
+
+typedef struct {
+  long binary;         /* Powers done by repeated squaring */
+  long transcendental; /* Powers that needed exp/expm1 and log1p */
+} FinPowCounts;
+
+/**
+ * Read this thread's counters, then zero them if `reset` is set
+ */
+void fin_pow_counts(FinPowCounts *out, int reset);
+#endif
+
+#endif /* FINMATH_H */
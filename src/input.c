@@ -4,6 +4,7 @@
  */
 
 #include "input.h"
+#include "cashflow.h"
 #include "config.h"
 #include "hal/hal_system.h"
 #include "tvm.h"
@@ -31,8 +32,7 @@ void calc_init(Calculator *calc, CalculatorModel model) {
   calc->tvm.mode = TVM_END;
 
   /* Initialize cash flow */
-  calc->cashflow.CF0 = 0.0;
-  calc->cashflow.count = 0;
+  cf_init(&calc->cashflow);
 
   /* Initialize memory registers (M0-M9) */
   memory_init(&calc->memory);
@@ -78,9 +78,7 @@ void calc_reset_tvm(Calculator *calc) {
 }
 
 void calc_reset_cashflow(Calculator *calc) {
-  calc->cashflow.CF0 = 0.0;
-  calc->cashflow.count = 0;
-  memset(calc->cashflow.flows, 0, sizeof(calc->cashflow.flows));
+  cf_init(&calc->cashflow);
 }
 
 void calc_reset_bond(Calculator *calc) {
@@ -98,6 +96,7 @@ void calc_reset_bond(Calculator *calc) {
   calc->bond.accruedInterest = 0.0;
   calc->bond.duration = 0.0;
   calc->bond.modDuration = 0.0;
+  calc->wsGeneration++; /* Invalidate cached worksheet outputs */
 }
 
 void calc_reset_depreciation(Calculator *calc) {
@@ -107,6 +106,7 @@ void calc_reset_depreciation(Calculator *calc) {
   calc->depreciation.dbRate = 200.0; /* Default DB rate */
   calc->depreciation.startMonth = 1;
   calc->depreciation.currentYear = 1;
+  calc->wsGeneration++; /* Invalidate cached worksheet outputs */
 }
 
 void calc_reset_statistics(Calculator *calc) {
@@ -283,9 +283,11 @@ void tvm_store(Calculator *calc, TVMVariable var, double value) {
   switch (var) {
   case TVM_VAR_N:
     calc->tvm.N = value;
+    calc->tvm.cache.valid = 0;
     break;
   case TVM_VAR_IY:
     calc->tvm.I_Y = value;
+    calc->tvm.cache.valid = 0;
     break;
   case TVM_VAR_PV:
     calc->tvm.PV = value;
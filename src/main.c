@@ -6,6 +6,7 @@
  * Using fxSDK / gint library
  */
 
+#include "bench.h"
 #include "cashflow.h"
 #include "config.h"
 #include "features.h"
@@ -645,6 +646,13 @@ int main(int argc, char *argv[]) {
     return (suite.failed == 0) ? 0 : 1;
   }
 
+  /* Check for benchmark mode */
+  if (argc > 1 && strcmp(argv[1], "--bench") == 0) {
+    printf("\n⏱  Running Open fx-BA Microbenchmarks...\n");
+    bench_run_all();
+    return 0;
+  }
+
   /* Initialize calculator state */
   calc_init(&calc, MODEL_STANDARD);
 
@@ -656,6 +664,7 @@ int main(int argc, char *argv[]) {
   printf("╠══════════════════════════════════════════════════════════════╣\n");
   printf("║  Run with --test flag to execute CFA validation tests       ║\n");
   printf("║  Example: ./fx-ba-test --test                                ║\n");
+  printf("║  Run with --bench flag for microbenchmarks (make bench)     ║\n");
   printf(
       "╚══════════════════════════════════════════════════════════════╝\n\n");
 
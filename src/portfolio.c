@@ -0,0 +1,277 @@
+/**
+ * Open fx-BA: TI BA II Plus Clone
+ * portfolio.c - Multithreaded bond, cash flow and rate sheet evaluation
+ *
+ * Relies on the bond, cash flow and TVM grid APIs being reentrant: every
+ * worker reads the shared input array and writes only its own slots of
+ * the result arrays. Solver scratch lives on each worker's stack.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "portfolio.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+/* ============================================================
+ * Per-Item Calculation
+ * ============================================================ */
+
+typedef struct {
+  const BondInput *inputs;
+  const double *knownPrice;
+  const double *knownYield;
+  BondResult *results;
+  int *errors;
+} PortfolioBook;
+
+static int portfolio_price_one(const void *context, int i) {
+  const PortfolioBook *book = (const PortfolioBook *)context;
+  double price = book->knownPrice ? book->knownPrice[i] : 0.0;
+  double yield =
+      book->knownYield ? book->knownYield[i] : book->inputs[i].couponRate;
+  int errorCode;
+
+  book->results[i] =
+      bond_calculate(&book->inputs[i], price, yield, &errorCode);
+
+  if (book->errors)
+    book->errors[i] = errorCode;
+  return errorCode == ERR_NONE;
+}
+
+typedef struct {
+  const CashFlowList *lists;    /* One of lists/series is set */
+  const CashFlowSeries *series;
+  double rate;
+  double financeRate;
+  double reinvestRate;
+  CashFlowMetrics *results;
+  int *errors;
+} PortfolioProjects;
+
+static int portfolio_project_one(const void *context, int i) {
+  const PortfolioProjects *book = (const PortfolioProjects *)context;
+  int errorCode;
+
+  if (book->lists)
+    errorCode = cf_metrics(&book->lists[i], book->rate, book->financeRate,
+                           book->reinvestRate, &book->results[i]);
+  else
+    errorCode = cf_series_metrics(&book->series[i], book->rate,
+                                  book->financeRate, book->reinvestRate,
+                                  &book->results[i]);
+
+  if (book->errors)
+    book->errors[i] = errorCode;
+  return errorCode == ERR_NONE;
+}
+
+typedef struct {
+  const TVMGrid *grid;
+  double *pmt;
+  double *balance;
+} PortfolioGrid;
+
+/* One rate column of the sheet */
+static int portfolio_grid_column(const void *context, int i) {
+  const PortfolioGrid *sheet = (const PortfolioGrid *)context;
+  tvm_grid_column(sheet->grid, i, sheet->pmt, sheet->balance);
+  return 1;
+}
+
+/* ============================================================
+ * Work-Stealing Scheduler
+ * ============================================================ */
+
+/*
+ * Each worker owns the half-open range [begin, end). The owner takes
+ * chunks from the front; thieves take the back half. Ranges only ever
+ * shrink or move between workers, so once a worker finds every range
+ * empty there is nothing left for it to do.
+ */
+typedef struct {
+  pthread_mutex_t lock;
+  int begin;
+  int end;
+  int solved;
+  int index;
+  int workerCount;
+  struct PortfolioPool *pool;
+  char pad[64]; /* Keep neighbouring locks off one cache line */
+} PortfolioWorker;
+
+typedef int (*PortfolioSolveFn)(const void *book, int i);
+
+typedef struct PortfolioPool {
+  PortfolioSolveFn solve; /* Computes item i; returns 1 when error-free */
+  const void *book;
+  PortfolioWorker *workers;
+} PortfolioPool;
+
+/* Claim up to PORTFOLIO_CHUNK items from the front of a worker's range */
+static int portfolio_claim(PortfolioWorker *w, int *begin, int *end) {
+  pthread_mutex_lock(&w->lock);
+  *begin = w->begin;
+  *end = w->begin + PORTFOLIO_CHUNK;
+  if (*end > w->end)
+    *end = w->end;
+  w->begin = *end;
+  pthread_mutex_unlock(&w->lock);
+  return *end > *begin;
+}
+
+/* Move the back half of a victim's range into the thief's range */
+static int portfolio_steal(PortfolioWorker *thief, PortfolioWorker *victim) {
+  int begin, end;
+
+  pthread_mutex_lock(&victim->lock);
+  end = victim->end;
+  begin = end - (end - victim->begin + 1) / 2;
+  victim->end = begin;
+  pthread_mutex_unlock(&victim->lock);
+
+  if (end <= begin)
+    return 0;
+
+  pthread_mutex_lock(&thief->lock);
+  thief->begin = begin;
+  thief->end = end;
+  pthread_mutex_unlock(&thief->lock);
+  return 1;
+}
+
+static void *portfolio_worker_run(void *arg) {
+  PortfolioWorker *self = (PortfolioWorker *)arg;
+  PortfolioWorker *workers = self->pool->workers;
+  PortfolioSolveFn solve = self->pool->solve;
+  const void *book = self->pool->book;
+  int begin, end;
+
+  for (;;) {
+    while (portfolio_claim(self, &begin, &end)) {
+      for (int i = begin; i < end; i++)
+        self->solved += solve(book, i);
+    }
+
+    int stolen = 0;
+    for (int k = 1; k < self->workerCount && !stolen; k++) {
+      int victim = (self->index + k) % self->workerCount;
+      stolen = portfolio_steal(self, &workers[victim]);
+    }
+    if (!stolen)
+      break;
+  }
+
+  return NULL;
+}
+
+/* Run solve(book, i) for every i in [0, count) on up to `threads` threads */
+static int portfolio_run(PortfolioSolveFn solve, const void *book, int count,
+                         int threads) {
+  if (count <= 0)
+    return 0;
+
+  if (threads <= 0)
+    threads = portfolio_default_threads();
+  if (threads > PORTFOLIO_MAX_THREADS)
+    threads = PORTFOLIO_MAX_THREADS;
+  if (threads > (count + PORTFOLIO_CHUNK - 1) / PORTFOLIO_CHUNK)
+    threads = (count + PORTFOLIO_CHUNK - 1) / PORTFOLIO_CHUNK;
+
+  PortfolioWorker *workers = NULL;
+  if (threads > 1)
+    workers = (PortfolioWorker *)calloc((size_t)threads,
+                                        sizeof(PortfolioWorker));
+
+  /* Single thread (or no memory for the pool): solve inline */
+  if (!workers) {
+    int solved = 0;
+    for (int i = 0; i < count; i++)
+      solved += solve(book, i);
+    return solved;
+  }
+
+  PortfolioPool pool = {solve, book, workers};
+  pthread_t tids[PORTFOLIO_MAX_THREADS];
+
+  for (int t = 0; t < threads; t++) {
+    PortfolioWorker *w = &workers[t];
+    pthread_mutex_init(&w->lock, NULL);
+    w->begin = (int)((long long)count * t / threads);
+    w->end = (int)((long long)count * (t + 1) / threads);
+    w->index = t;
+    w->workerCount = threads;
+    w->pool = &pool;
+  }
+
+  /* The caller is worker 0; a failed spawn just leaves more to steal */
+  int started[PORTFOLIO_MAX_THREADS] = {0};
+  for (int t = 1; t < threads; t++)
+    started[t] =
+        pthread_create(&tids[t], NULL, portfolio_worker_run, &workers[t]) == 0;
+  portfolio_worker_run(&workers[0]);
+
+  int solved = workers[0].solved;
+  for (int t = 1; t < threads; t++) {
+    if (started[t])
+      pthread_join(tids[t], NULL);
+    solved += workers[t].solved;
+  }
+
+  for (int t = 0; t < threads; t++)
+    pthread_mutex_destroy(&workers[t].lock);
+  free(workers);
+
+  return solved;
+}
+
+/* ============================================================
+ * Public API
+ * ============================================================ */
+
+int portfolio_default_threads(void) {
+  long n = sysconf(_SC_NPROCESSORS_ONLN);
+  if (n < 1)
+    return 1;
+  if (n > PORTFOLIO_MAX_THREADS)
+    return PORTFOLIO_MAX_THREADS;
+  return (int)n;
+}
+
+int portfolio_calculate(const BondInput inputs[], const double knownPrice[],
+                        const double knownYield[], BondResult results[],
+                        int errors[], int count, int threads) {
+  PortfolioBook book = {inputs, knownPrice, knownYield, results, errors};
+  return portfolio_run(portfolio_price_one, &book, count, threads);
+}
+
+int portfolio_cashflow(const CashFlowList projects[], double rate,
+                       double financeRate, double reinvestRate,
+                       CashFlowMetrics results[], int errors[], int count,
+                       int threads) {
+  PortfolioProjects book = {projects,     NULL,    rate, financeRate,
+                            reinvestRate, results, errors};
+  return portfolio_run(portfolio_project_one, &book, count, threads);
+}
+
+int portfolio_cashflow_series(const CashFlowSeries projects[], double rate,
+                              double financeRate, double reinvestRate,
+                              CashFlowMetrics results[], int errors[],
+                              int count, int threads) {
+  PortfolioProjects book = {NULL,         projects, rate, financeRate,
+                            reinvestRate, results,  errors};
+  return portfolio_run(portfolio_project_one, &book, count, threads);
+}
+
+int portfolio_tvm_grid(const TVMGrid *grid, double pmt[], double balance[],
+                       int threads) {
+  int errorCode = tvm_grid_check(grid);
+  if (errorCode != ERR_NONE)
+    return errorCode;
+
+  PortfolioGrid sheet = {grid, pmt, balance};
+  portfolio_run(portfolio_grid_column, &sheet, grid->rateCount, threads);
+  return ERR_NONE;
+}
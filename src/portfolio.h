@@ -0,0 +1,103 @@
+/**
+ * Open fx-BA: TI BA II Plus Clone
+ * portfolio.h - Multithreaded bond, cash flow and rate sheet evaluation
+ *
+ * Built only by the host Makefile targets (never part of the add-in).
+ */
+
+#ifndef PORTFOLIO_H
+#define PORTFOLIO_H
+
+#include "bond.h"
+#include "cashflow.h"
+#include "tvm.h"
+
+/* ============================================================
+ * Scheduler Limits
+ * ============================================================ */
+#define PORTFOLIO_MAX_THREADS 64 /* Upper bound on worker threads */
+#define PORTFOLIO_CHUNK 32       /* Items an owner claims per grab */
+
+/* ============================================================
+ * Portfolio Functions
+ * ============================================================ */
+
+/**
+ * Number of online processors (at least 1).
+ */
+int portfolio_default_threads(void);
+
+/**
+ * Compute the full BondResult for every bond in a book.
+ *
+ * Work is split into one contiguous range per thread. Each thread claims
+ * PORTFOLIO_CHUNK bonds at a time from the front of its own range, and an
+ * idle thread steals the back half of another thread's range, so books
+ * where some yield solves run long still finish evenly.
+ *
+ * @param inputs Bond parameters (read-only, shared by all threads)
+ * @param knownPrice Per-bond price; where > 0 the yield is solved,
+ *                   otherwise the price comes from knownYield (may be NULL)
+ * @param knownYield Per-bond yield, or warm start for the yield solve
+ *                   (may be NULL when every knownPrice is > 0)
+ * @param results Output: one BondResult per bond
+ * @param errors Output: per-bond ERR_* code as returned by bond_calculate
+ *               (may be NULL)
+ * @param count Number of bonds
+ * @param threads Worker threads including the caller; <= 0 uses
+ *                portfolio_default_threads()
+ * @return Number of bonds computed without error
+ */
+int portfolio_calculate(const BondInput inputs[], const double knownPrice[],
+                        const double knownYield[], BondResult results[],
+                        int errors[], int count, int threads);
+
+/**
+ * Compute cf_metrics for every project in a list of candidates.
+ *
+ * Scheduled like portfolio_calculate. Projects are only read (no cache
+ * writes), and each thread writes only its own slots of results/errors.
+ *
+ * @param projects Cash flow lists (read-only, shared by all threads)
+ * @param rate Discount rate for NPV and discounted payback (decimal)
+ * @param financeRate MIRR rate for negative cash flows (decimal)
+ * @param reinvestRate MIRR rate for positive cash flows (decimal)
+ * @param results Output: one CashFlowMetrics per project
+ * @param errors Output: per-project ERR_* code as returned by cf_metrics
+ *               (may be NULL)
+ * @param count Number of projects
+ * @param threads Worker threads including the caller; <= 0 uses
+ *                portfolio_default_threads()
+ * @return Number of projects computed without error
+ */
+int portfolio_cashflow(const CashFlowList projects[], double rate,
+                       double financeRate, double reinvestRate,
+                       CashFlowMetrics results[], int errors[], int count,
+                       int threads);
+
+/**
+ * portfolio_cashflow over arena-backed series (see cf_series_metrics)
+ */
+int portfolio_cashflow_series(const CashFlowSeries projects[], double rate,
+                              double financeRate, double reinvestRate,
+                              CashFlowMetrics results[], int errors[],
+                              int count, int threads);
+
+/**
+ * Fill a rate x term grid (see tvm_grid) with rate columns spread over
+ * threads.
+ *
+ * Scheduled like portfolio_calculate, claiming PORTFOLIO_CHUNK adjacent
+ * columns at a time so threads rarely write the same cache line of the
+ * row-major outputs. Results are identical to tvm_grid.
+ *
+ * @param pmt Output: rateCount * termCount payments, row-major
+ * @param balance Output: same layout for balances (may be NULL)
+ * @param threads Worker threads including the caller; <= 0 uses
+ *                portfolio_default_threads()
+ * @return ERR_NONE, or the tvm_grid_check error (nothing written)
+ */
+int portfolio_tvm_grid(const TVMGrid *grid, double pmt[], double balance[],
+                       int threads);
+
+#endif /* PORTFOLIO_H */
@@ -29,280 +29,304 @@ const char *stat_regression_name(RegressionType type) {
 }
 
 /* ============================================================
- * Initialization
- * ============================================================ */
-
-void stat_init(StatData *stat) {
-  stat_clear(stat);
-  stat->regType = REG_LINEAR;
-}
-
-void stat_clear(StatData *stat) {
-  memset(stat->xData, 0, sizeof(stat->xData));
-  memset(stat->yData, 0, sizeof(stat->yData));
-  stat->count = 0;
-}
-
-/* ============================================================
- * Data Management
+ * Online Moments (Welford)
  * ============================================================ */
 
-int stat_add_x(StatData *stat, double x) {
-  if (stat->count >= STAT_MAX_POINTS)
-    return 0;
-
-  stat->xData[stat->count] = x;
-  stat->yData[stat->count] = 0.0; /* Not used for 1-var */
-  stat->count++;
-
-  return 1;
+/*
+ * Welford's update keeps the mean and the centered sums directly, so the
+ * variance never comes from Σx² - n·x̄², which cancels badly when the
+ * spread is small next to the mean. Removal runs the same update
+ * backwards:
+ *   x̄'  = x̄ - (x - x̄) / (n-1)
+ *   M2' = M2 - (x - x̄')(x - x̄)
+ *   C'  = C  - (x - x̄')(y - ȳ)
+ */
+static void moments_add(StatMoments *m, double x, double y) {
+  m->n++;
+  double dx = x - m->meanX;
+  double dy = y - m->meanY;
+  m->meanX += dx / (double)m->n;
+  m->meanY += dy / (double)m->n;
+  m->m2X += dx * (x - m->meanX);
+  m->m2Y += dy * (y - m->meanY);
+  m->cXY += dx * (y - m->meanY);
 }
 
-int stat_add_xy(StatData *stat, double x, double y) {
-  if (stat->count >= STAT_MAX_POINTS)
-    return 0;
+static void moments_remove(StatMoments *m, double x, double y) {
+  if (m->n <= 1) {
+    memset(m, 0, sizeof(StatMoments));
+    return;
+  }
 
-  stat->xData[stat->count] = x;
-  stat->yData[stat->count] = y;
-  stat->count++;
+  double n1 = (double)(m->n - 1);
+  double meanX = m->meanX - (x - m->meanX) / n1;
+  double meanY = m->meanY - (y - m->meanY) / n1;
 
-  return 1;
-}
-
-void stat_remove_last(StatData *stat) {
-  if (stat->count > 0) {
-    stat->count--;
+  m->n--;
+  if (m->n == 1) {
+    /* A single point has no spread; drop any rounding residue */
+    m->m2X = m->m2Y = m->cXY = 0.0;
+  } else {
+    m->m2X -= (x - meanX) * (x - m->meanX);
+    m->m2Y -= (y - meanY) * (y - m->meanY);
+    m->cXY -= (x - meanX) * (y - m->meanY);
   }
+  m->meanX = meanX;
+  m->meanY = meanY;
 }
 
-/* ============================================================
- * 1-Variable Statistics
- * ============================================================ */
-
-Stat1VarResult stat_calc_1var(StatData *stat) {
-  Stat1VarResult result = {0};
+/* Least squares y = a + bx from the centered sums */
+static RegressionResult moments_regression(const StatMoments *m) {
+  RegressionResult result = {REG_LINEAR, 0, 0, 0, 0};
 
-  if (stat->count == 0)
+  if (m->n < 2)
     return result;
 
-  result.n = stat->count;
-
-  /* First pass: sum, sum of squares, min, max */
-  result.min = stat->xData[0];
-  result.max = stat->xData[0];
+  /* b = Σ(x-x̄)(y-ȳ) / Σ(x-x̄)² */
+  if (m->m2X == 0) {
+    result.b = 0;
+  } else {
+    result.b = m->cXY / m->m2X;
+  }
 
-  for (int i = 0; i < stat->count; i++) {
-    double x = stat->xData[i];
-    result.sum += x;
-    result.sumSq += x * x;
+  /* a = ȳ - b*x̄ */
+  result.a = m->meanY - result.b * m->meanX;
 
-    if (x < result.min)
-      result.min = x;
-    if (x > result.max)
-      result.max = x;
+  /* Correlation coefficient r */
+  if (m->m2X > 0 && m->m2Y > 0) {
+    result.r = m->cXY / sqrt(m->m2X * m->m2Y);
   }
 
-  /* Mean */
-  result.mean = result.sum / (double)result.n;
-
-  /* Standard deviation */
-  if (result.n > 0) {
-    /* Population std dev: sqrt(Σ(x-mean)² / n) */
-    double variance =
-        (result.sumSq / (double)result.n) - (result.mean * result.mean);
-    if (variance < 0)
-      variance = 0; /* Numerical stability */
-    result.stdDevP = sqrt(variance);
-
-    /* Sample std dev: sqrt(Σ(x-mean)² / (n-1)) */
-    if (result.n > 1) {
-      double sampleVar = (result.sumSq - result.n * result.mean * result.mean) /
-                         (double)(result.n - 1);
-      if (sampleVar < 0)
-        sampleVar = 0;
-      result.stdDevS = sqrt(sampleVar);
-    }
-  }
+  result.rSq = result.r * result.r;
 
   return result;
 }
 
 /* ============================================================
- * 2-Variable Statistics
+ * Accumulator
  * ============================================================ */
 
-Stat2VarResult stat_calc_2var(StatData *stat) {
-  Stat2VarResult result = {0};
-
-  if (stat->count == 0)
-    return result;
-
-  result.n = stat->count;
+void stat_acc_init(StatAccumulator *acc) {
+  memset(acc, 0, sizeof(StatAccumulator));
+}
 
-  /* Calculate sums */
-  for (int i = 0; i < stat->count; i++) {
-    double x = stat->xData[i];
-    double y = stat->yData[i];
+void stat_acc_add(StatAccumulator *acc, double x, double y) {
+  moments_add(&acc->raw, x, y);
+  if (x > 0)
+    moments_add(&acc->logX, log(x), y);
+  if (y > 0)
+    moments_add(&acc->logY, x, log(y));
+  if (x > 0 && y > 0)
+    moments_add(&acc->logXY, log(x), log(y));
+
+  acc->sumX += x;
+  acc->sumY += y;
+  acc->sumXSq += x * x;
+  acc->sumYSq += y * y;
+  acc->sumXY += x * y;
+}
 
-    result.sumX += x;
-    result.sumY += y;
-    result.sumXSq += x * x;
-    result.sumYSq += y * y;
-    result.sumXY += x * y;
-  }
+void stat_acc_remove(StatAccumulator *acc, double x, double y) {
+  if (acc->raw.n == 0)
+    return;
 
-  /* Means */
-  result.meanX = result.sumX / (double)result.n;
-  result.meanY = result.sumY / (double)result.n;
-
-  /* Standard deviations */
-  if (result.n > 0) {
-    /* Population */
-    double varX =
-        (result.sumXSq / (double)result.n) - (result.meanX * result.meanX);
-    double varY =
-        (result.sumYSq / (double)result.n) - (result.meanY * result.meanY);
-    if (varX < 0)
-      varX = 0;
-    if (varY < 0)
-      varY = 0;
-    result.stdDevXP = sqrt(varX);
-    result.stdDevYP = sqrt(varY);
-
-    /* Sample */
-    if (result.n > 1) {
-      double sVarX = (result.sumXSq - result.n * result.meanX * result.meanX) /
-                     (double)(result.n - 1);
-      double sVarY = (result.sumYSq - result.n * result.meanY * result.meanY) /
-                     (double)(result.n - 1);
-      if (sVarX < 0)
-        sVarX = 0;
-      if (sVarY < 0)
-        sVarY = 0;
-      result.stdDevXS = sqrt(sVarX);
-      result.stdDevYS = sqrt(sVarY);
-    }
+  if (acc->raw.n == 1) {
+    stat_acc_init(acc);
+    return;
   }
 
-  return result;
+  moments_remove(&acc->raw, x, y);
+  if (x > 0)
+    moments_remove(&acc->logX, log(x), y);
+  if (y > 0)
+    moments_remove(&acc->logY, x, log(y));
+  if (x > 0 && y > 0)
+    moments_remove(&acc->logXY, log(x), log(y));
+
+  acc->sumX -= x;
+  acc->sumY -= y;
+  acc->sumXSq -= x * x;
+  acc->sumYSq -= y * y;
+  acc->sumXY -= x * y;
 }
 
-/* ============================================================
- * Regression Calculations
- * ============================================================ */
-
-/* Helper for linear regression on transformed data */
-static RegressionResult linear_regression(double *x, double *y, int n) {
-  RegressionResult result = {REG_LINEAR, 0, 0, 0, 0};
+Stat1VarResult stat_acc_1var(const StatAccumulator *acc) {
+  Stat1VarResult result = {0};
+  const StatMoments *m = &acc->raw;
 
-  if (n < 2)
+  if (m->n == 0)
     return result;
 
-  double sumX = 0, sumY = 0, sumXY = 0, sumXSq = 0, sumYSq = 0;
+  result.n = m->n;
+  result.sum = acc->sumX;
+  result.sumSq = acc->sumXSq;
+  result.mean = m->meanX;
 
-  for (int i = 0; i < n; i++) {
-    sumX += x[i];
-    sumY += y[i];
-    sumXY += x[i] * y[i];
-    sumXSq += x[i] * x[i];
-    sumYSq += y[i] * y[i];
-  }
+  double m2 = (m->m2X > 0) ? m->m2X : 0.0;
 
-  double meanX = sumX / n;
-  double meanY = sumY / n;
+  /* Population std dev: sqrt(Σ(x-mean)² / n) */
+  result.stdDevP = sqrt(m2 / (double)m->n);
 
-  /* b = Σ(x-x̄)(y-ȳ) / Σ(x-x̄)² */
-  double sxy = sumXY - n * meanX * meanY;
-  double sxx = sumXSq - n * meanX * meanX;
-  double syy = sumYSq - n * meanY * meanY;
+  /* Sample std dev: sqrt(Σ(x-mean)² / (n-1)) */
+  if (m->n > 1)
+    result.stdDevS = sqrt(m2 / (double)(m->n - 1));
 
-  if (sxx == 0) {
-    result.b = 0;
-  } else {
-    result.b = sxy / sxx;
-  }
+  return result;
+}
 
-  /* a = ȳ - b*x̄ */
-  result.a = meanY - result.b * meanX;
+Stat2VarResult stat_acc_2var(const StatAccumulator *acc) {
+  Stat2VarResult result = {0};
+  const StatMoments *m = &acc->raw;
 
-  /* Correlation coefficient r */
-  if (sxx > 0 && syy > 0) {
-    result.r = sxy / sqrt(sxx * syy);
-  }
+  if (m->n == 0)
+    return result;
 
-  result.rSq = result.r * result.r;
+  result.n = m->n;
+  result.sumX = acc->sumX;
+  result.sumY = acc->sumY;
+  result.sumXSq = acc->sumXSq;
+  result.sumYSq = acc->sumYSq;
+  result.sumXY = acc->sumXY;
+  result.meanX = m->meanX;
+  result.meanY = m->meanY;
+
+  double m2X = (m->m2X > 0) ? m->m2X : 0.0;
+  double m2Y = (m->m2Y > 0) ? m->m2Y : 0.0;
+
+  /* Population */
+  result.stdDevXP = sqrt(m2X / (double)m->n);
+  result.stdDevYP = sqrt(m2Y / (double)m->n);
+
+  /* Sample */
+  if (m->n > 1) {
+    result.stdDevXS = sqrt(m2X / (double)(m->n - 1));
+    result.stdDevYS = sqrt(m2Y / (double)(m->n - 1));
+  }
 
   return result;
 }
 
-RegressionResult stat_regression(StatData *stat, RegressionType type) {
+RegressionResult stat_acc_regression(const StatAccumulator *acc,
+                                     RegressionType type) {
   RegressionResult result = {type, 0, 0, 0, 0};
 
-  if (stat->count < 2)
+  if (acc->raw.n < 2)
     return result;
 
-  double xTrans[STAT_MAX_POINTS];
-  double yTrans[STAT_MAX_POINTS];
-  int validCount = 0;
-
   switch (type) {
   case REG_LINEAR:
     /* y = a + bx (no transformation) */
-    result = linear_regression(stat->xData, stat->yData, stat->count);
-    result.type = REG_LINEAR;
+    result = moments_regression(&acc->raw);
     break;
 
   case REG_LOGARITHMIC:
     /* y = a + b*ln(x) → transform x = ln(x) */
-    for (int i = 0; i < stat->count; i++) {
-      if (stat->xData[i] > 0) {
-        xTrans[validCount] = log(stat->xData[i]);
-        yTrans[validCount] = stat->yData[i];
-        validCount++;
-      }
-    }
-    if (validCount >= 2) {
-      result = linear_regression(xTrans, yTrans, validCount);
-    }
-    result.type = REG_LOGARITHMIC;
+    result = moments_regression(&acc->logX);
     break;
 
   case REG_EXPONENTIAL:
     /* y = a*e^(bx) → ln(y) = ln(a) + bx */
-    for (int i = 0; i < stat->count; i++) {
-      if (stat->yData[i] > 0) {
-        xTrans[validCount] = stat->xData[i];
-        yTrans[validCount] = log(stat->yData[i]);
-        validCount++;
-      }
-    }
-    if (validCount >= 2) {
-      result = linear_regression(xTrans, yTrans, validCount);
+    if (acc->logY.n >= 2) {
+      result = moments_regression(&acc->logY);
       result.a = exp(result.a); /* Convert back from ln(a) */
     }
-    result.type = REG_EXPONENTIAL;
     break;
 
   case REG_POWER:
     /* y = a*x^b → ln(y) = ln(a) + b*ln(x) */
-    for (int i = 0; i < stat->count; i++) {
-      if (stat->xData[i] > 0 && stat->yData[i] > 0) {
-        xTrans[validCount] = log(stat->xData[i]);
-        yTrans[validCount] = log(stat->yData[i]);
-        validCount++;
-      }
-    }
-    if (validCount >= 2) {
-      result = linear_regression(xTrans, yTrans, validCount);
+    if (acc->logXY.n >= 2) {
+      result = moments_regression(&acc->logXY);
       result.a = exp(result.a); /* Convert back from ln(a) */
     }
-    result.type = REG_POWER;
     break;
   }
 
+  result.type = type;
   return result;
 }
 
+/* ============================================================
+ * Initialization
+ * ============================================================ */
+
+void stat_init(StatData *stat) {
+  stat_clear(stat);
+  stat->regType = REG_LINEAR;
+}
+
+void stat_clear(StatData *stat) {
+  memset(stat->xData, 0, sizeof(stat->xData));
+  memset(stat->yData, 0, sizeof(stat->yData));
+  stat->count = 0;
+  stat_acc_init(&stat->acc);
+}
+
+/* ============================================================
+ * Data Management
+ * ============================================================ */
+
+int stat_add_x(StatData *stat, double x) {
+  /* Not used for 1-var */
+  return stat_add_xy(stat, x, 0.0);
+}
+
+int stat_add_xy(StatData *stat, double x, double y) {
+  if (stat->count >= STAT_MAX_POINTS)
+    return 0;
+
+  int i = stat->count;
+  stat->xData[i] = x;
+  stat->yData[i] = y;
+
+  /* Prefix extremes make min/max survive stat_remove_last in O(1) */
+  stat->minX[i] = (i == 0 || x < stat->minX[i - 1]) ? x : stat->minX[i - 1];
+  stat->maxX[i] = (i == 0 || x > stat->maxX[i - 1]) ? x : stat->maxX[i - 1];
+
+  stat_acc_add(&stat->acc, x, y);
+  stat->count++;
+
+  return 1;
+}
+
+void stat_remove_last(StatData *stat) {
+  if (stat->count > 0) {
+    stat->count--;
+    stat_acc_remove(&stat->acc, stat->xData[stat->count],
+                    stat->yData[stat->count]);
+  }
+}
+
+/* ============================================================
+ * 1-Variable Statistics
+ * ============================================================ */
+
+Stat1VarResult stat_calc_1var(StatData *stat) {
+  Stat1VarResult result = stat_acc_1var(&stat->acc);
+
+  if (stat->count > 0) {
+    result.min = stat->minX[stat->count - 1];
+    result.max = stat->maxX[stat->count - 1];
+  }
+
+  return result;
+}
+
+/* ============================================================
+ * 2-Variable Statistics
+ * ============================================================ */
+
+Stat2VarResult stat_calc_2var(StatData *stat) {
+  return stat_acc_2var(&stat->acc);
+}
+
+/* ============================================================
+ * Regression Calculations
+ * ============================================================ */
+
+RegressionResult stat_regression(StatData *stat, RegressionType type) {
+  return stat_acc_regression(&stat->acc, type);
+}
+
 /* ============================================================
  * Prediction Functions
  * ============================================================ */
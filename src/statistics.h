@@ -64,6 +64,37 @@ typedef struct {
   double rSq; /* R² (coefficient of determination) */
 } RegressionResult;
 
+/* ============================================================
+ * Online Accumulators (Welford)
+ * ============================================================ */
+
+/* Running moments of one (x, y) series */
+typedef struct {
+  int n;        /* Points in the series */
+  double meanX; /* x̄ */
+  double meanY; /* ȳ */
+  double m2X;   /* Σ(x-x̄)² */
+  double m2Y;   /* Σ(y-ȳ)² */
+  double cXY;   /* Σ(x-x̄)(y-ȳ) */
+} StatMoments;
+
+/*
+ * Everything the 1-var, 2-var and regression results need, kept up to
+ * date per point. The log series hold only the points where the
+ * transform is defined, as stat_regression has always filtered them.
+ */
+typedef struct {
+  StatMoments raw;   /* (x, y) */
+  StatMoments logX;  /* (ln x, y), x > 0: logarithmic */
+  StatMoments logY;  /* (x, ln y), y > 0: exponential */
+  StatMoments logXY; /* (ln x, ln y), x, y > 0: power */
+  double sumX;       /* Σx */
+  double sumY;       /* Σy */
+  double sumXSq;     /* Σx² */
+  double sumYSq;     /* Σy² */
+  double sumXY;      /* Σxy */
+} StatAccumulator;
+
 /* ============================================================
  * Statistics Data Storage
  * ============================================================ */
@@ -72,6 +103,9 @@ typedef struct {
   double yData[STAT_MAX_POINTS];
   int count;
   RegressionType regType;
+  StatAccumulator acc;          /* Moments of the points above */
+  double minX[STAT_MAX_POINTS]; /* minX[i] = min of xData[0..i] */
+  double maxX[STAT_MAX_POINTS]; /* maxX[i] = max of xData[0..i] */
 } StatData;
 
 /* ============================================================
@@ -89,17 +123,17 @@ void stat_init(StatData *stat);
 void stat_clear(StatData *stat);
 
 /**
- * Add a data point (1-variable).
+ * Add a data point (1-variable). O(1).
  */
 int stat_add_x(StatData *stat, double x);
 
 /**
- * Add a data point (2-variable).
+ * Add a data point (2-variable). O(1).
  */
 int stat_add_xy(StatData *stat, double x, double y);
 
 /**
- * Remove last data point.
+ * Remove last data point. O(1).
  */
 void stat_remove_last(StatData *stat);
 
@@ -118,6 +152,44 @@ Stat2VarResult stat_calc_2var(StatData *stat);
  */
 RegressionResult stat_regression(StatData *stat, RegressionType type);
 
+/* ============================================================
+ * Accumulator Functions
+ *
+ * Add and remove are O(1); every result is read in O(1) from the
+ * moments, without rescanning the data.
+ * ============================================================ */
+
+/**
+ * Reset an accumulator to no points (all-zero memory is also empty).
+ */
+void stat_acc_init(StatAccumulator *acc);
+
+/**
+ * Add a point (use y = 0 for 1-variable data).
+ */
+void stat_acc_add(StatAccumulator *acc, double x, double y);
+
+/**
+ * Remove a point previously added with the same x and y.
+ */
+void stat_acc_remove(StatAccumulator *acc, double x, double y);
+
+/**
+ * 1-variable statistics of x (min and max are not tracked; left 0).
+ */
+Stat1VarResult stat_acc_1var(const StatAccumulator *acc);
+
+/**
+ * 2-variable statistics.
+ */
+Stat2VarResult stat_acc_2var(const StatAccumulator *acc);
+
+/**
+ * Regression of the given type.
+ */
+RegressionResult stat_acc_regression(const StatAccumulator *acc,
+                                     RegressionType type);
+
 /**
  * Predict y from x using current regression.
  */
@@ -10,9 +10,12 @@
  */
 
 #include "tests.h"
+#include "bond.h"
 #include "cashflow.h"
+#include "finmath.h"
 #include "input.h"
 #include "tvm.h"
+#include "xcashflow.h"
 #include <math.h>
 #include <stdio.h>
 #include <string.h>
@@ -611,29 +614,42 @@ TestResult test_s2_q6_sample_stddev(void) {
 
 /**
  * S2-Q7: Duration & Convexity
- * Modified Duration = 7.5, Convexity = 60
+ * 10-year 6% semi-annual bond at a 6% yield (30/360 basis, 2024-2034).
+ * Modified Duration ≈ 7.519 and Convexity ≈ 70.38 from bond_risk
  * Rate increase = 50 bps (0.50%)
- * Expected % Price Change = -3.675%
+ * Expected % Price Change = -3.671%
  *
  * Formula: %ΔP ≈ (-Dur × Δy) + (0.5 × Conv × Δy²)
- * = (-7.5 × 0.005) + (0.5 × 60 × 0.005²)
- * = -0.0375 + 0.00075 = -0.03675 = -3.675%
+ * = (-7.519 × 0.005) + (0.5 × 70.38 × 0.005²)
+ * = -0.037594 + 0.000880 = -0.036714 = -3.671%
+ *
+ * The estimate must also land within 0.01% of a full repricing at 6.5%.
  */
 TestResult test_s2_q7_duration_convexity(void) {
   TestResult result;
-  init_test_result(&result, "S2-Q7: Duration/Convex", "Level III", -3.675,
+  init_test_result(&result, "S2-Q7: Duration/Convex", "Level III", -3.671,
                    0.001);
 
-  double modDuration = 7.5;
-  double convexity = 60.0;
+  BondInput input = {0};
+  input.settlementDate = 20240101;
+  input.maturityDate = 20340101;
+  input.couponRate = 6.0;
+  input.redemption = 100.0;
+  input.frequency = COUPON_SEMI_ANNUAL;
+  input.dayCount = DAY_COUNT_30_360;
+
+  BondRisk risk = bond_risk(&input, 6.0);
   double deltaY = 0.005; /* 50 bps = 0.50% = 0.005 */
 
-  double durationEffect = -modDuration * deltaY;
-  double convexityEffect = 0.5 * convexity * deltaY * deltaY;
+  double durationEffect = -risk.modDuration * deltaY;
+  double convexityEffect = 0.5 * risk.convexity * deltaY * deltaY;
 
   result.actual =
       (durationEffect + convexityEffect) * 100.0; /* Convert to percentage */
+
+  double repriced = (bond_price(&input, 6.5) / risk.price - 1.0) * 100.0;
   result.passed =
+      fabs(result.actual - repriced) < 0.01 &&
       tests_check_value(result.expected, result.actual, result.tolerance);
 
   return result;
@@ -768,7 +784,6 @@ TestResult test_s2_q10_horizon_yield(void) {
  * Worksheet Integration Tests
  * ============================================================ */
 
-#include "bond.h"
 #include "depreciation.h"
 #include "statistics.h"
 
@@ -820,6 +835,44 @@ TestResult test_depreciation_db(void) {
   return result;
 }
 
+/**
+ * Depreciation: 40-year building schedule (DB-SL, 150%)
+ * Cost = $2,000,000, Salvage = $200,000, Life = 40 years
+ * Every row of depr_schedule must equal depr_calculate for that year, and
+ * the schedule must depreciate down to salvage.
+ * Expected accumulated depreciation = 1,800,000
+ */
+TestResult test_depreciation_schedule(void) {
+  TestResult result;
+  init_test_result(&result, "Depr Schedule 40y", "WS", 1800000.0, 0.01);
+
+  DepreciationInput input = {0};
+  input.cost = 2000000.0;
+  input.salvage = 200000.0;
+  input.life = 40.0;
+  input.dbRate = 150.0;
+  input.startMonth = 1;
+
+  DepreciationResult rows[48];
+  int count = depr_schedule(&input, DEPR_DB_SL, rows, 48);
+
+  int mismatches = 0;
+  for (int y = 1; y <= count; y++) {
+    DepreciationResult ref = depr_calculate(&input, DEPR_DB_SL, y);
+    if (ref.depreciation != rows[y - 1].depreciation ||
+        ref.bookValueStart != rows[y - 1].bookValueStart ||
+        ref.accumDepr != rows[y - 1].accumDepr)
+      mismatches++;
+  }
+
+  result.actual = (count > 0) ? rows[count - 1].accumDepr : 0.0;
+  result.passed =
+      count == 40 && mismatches == 0 &&
+      tests_check_value(result.expected, result.actual, result.tolerance);
+
+  return result;
+}
+
 /**
  * Bond: Price from Yield
  * 10-year, 6% coupon (semi-annual), YTM = 5%, Par = 100
@@ -829,7 +882,7 @@ TestResult test_bond_price(void) {
   TestResult result;
   init_test_result(&result, "Bond Price", "WS", 107.79, 0.50);
 
-  BondInput input;
+  BondInput input = {0};
   input.settlementDate = 20240101;
   input.maturityDate = 20340101;
   input.couponRate = 6.0;
@@ -1058,6 +1111,52 @@ TestResult test_amort_schedule(void) {
   return result;
 }
 
+/**
+ * Amortization: Streamed 30-year schedule
+ * $100,000 loan, 6% annual, PMT -599.55, all 360 rows through both a row
+ * buffer and a sink. Every row must match tvm_amort_period.
+ * Expected first-year interest = 5,966.59
+ */
+typedef struct {
+  double rate, pv, pmt;
+  double maxDiff;
+  double firstYearInterest;
+} AmortCheck;
+
+static int amort_check_sink(void *context, int period,
+                            const AmortResult *row) {
+  AmortCheck *check = (AmortCheck *)context;
+  AmortResult ref =
+      tvm_amort_period(period, 360, check->rate, check->pv, check->pmt);
+  double d = fabs(ref.interest - row->interest) +
+             fabs(ref.principal - row->principal) +
+             fabs(ref.balance - row->balance);
+  if (d > check->maxDiff)
+    check->maxDiff = d;
+  if (period <= 12)
+    check->firstYearInterest -= row->interest;
+  return 0;
+}
+
+TestResult test_amort_schedule_stream(void) {
+  TestResult result;
+  init_test_result(&result, "Amort Schedule Stream", "WS", 5966.59, 0.01);
+
+  static AmortResult rows[360];
+  AmortCheck check = {0.06 / 12.0, 100000.0, -599.55, 0.0, 0.0};
+
+  int count = tvm_amort_schedule(1, 360, check.rate, check.pv, check.pmt,
+                                 rows, 360, amort_check_sink, &check);
+
+  result.actual = check.firstYearInterest;
+  result.passed =
+      count == 360 && check.maxDiff < 1e-6 &&
+      fabs(rows[11].balance - 98771.99) < 0.01 &&
+      tests_check_value(result.expected, result.actual, result.tolerance);
+
+  return result;
+}
+
 /**
  * Breakeven: Calculate breakeven quantity
  * FC=$50,000, VC=$20/unit, P=$50/unit
@@ -1206,6 +1305,966 @@ TestResult test_regression_linear(void) {
   return result;
 }
 
+/**
+ * Statistics: Welford accumulator on offset data
+ * x = 1e9 + {4, 7, 13, 16}, plus a stray 1e9 + 100 that is then removed
+ * with stat_remove_last. Σx² - n·x̄² loses every digit here.
+ * Expected Sx = sqrt(30) = 5.4772, max back to 1e9 + 16
+ */
+TestResult test_statistics_welford(void) {
+  TestResult result;
+  init_test_result(&result, "Stats Welford Sx", "WS", 5.4772, 0.0001);
+
+  StatData stat;
+  stat_init(&stat);
+  stat_add_x(&stat, 1e9 + 4.0);
+  stat_add_x(&stat, 1e9 + 7.0);
+  stat_add_x(&stat, 1e9 + 13.0);
+  stat_add_x(&stat, 1e9 + 16.0);
+  stat_add_x(&stat, 1e9 + 100.0);
+  stat_remove_last(&stat);
+
+  Stat1VarResult res = stat_calc_1var(&stat);
+  result.actual = res.stdDevS;
+  result.passed =
+      res.n == 4 && res.max == 1e9 + 16.0 &&
+      tests_check_value(result.expected, result.actual, result.tolerance);
+
+  return result;
+}
+
+/**
+ * Cash Flow: Long frequency runs (grouped NPV)
+ * CF0 = -150,000, C01 = 1,000 (F=240), C02 = 1,500 (F=120), I = 0.5%/period
+ * Expected NPV = 30,397.04 (per-period summation)
+ */
+TestResult test_cf_grouped_npv(void) {
+  TestResult result;
+  init_test_result(&result, "CF Grouped NPV", "WS", 30397.04, 0.01);
+
+  CashFlowList cf;
+  cf_init(&cf);
+  cf_set_cf0(&cf, -150000);
+  cf_add(&cf, 1000, 240);
+  cf_add(&cf, 1500, 120);
+
+  result.actual = cf_npv(&cf, 0.005);
+  result.passed =
+      tests_check_value(result.expected, result.actual, result.tolerance);
+
+  return result;
+}
+
+/**
+ * Cash Flow: IRR over a maximum-length frequency run
+ * CF0 = -100,000, C01 = 10,000 (F=9999) is effectively a perpetuity
+ * Expected IRR = 10,000 / 100,000 = 10%
+ */
+TestResult test_cf_grouped_irr(void) {
+  TestResult result;
+  init_test_result(&result, "CF Grouped IRR", "WS", 10.00, 0.0001);
+
+  CashFlowList cf;
+  cf_init(&cf);
+  cf_set_cf0(&cf, -100000);
+  cf_add(&cf, 10000, 9999);
+
+  int errorCode;
+  result.actual = cf_irr(&cf, &errorCode) * 100.0;
+  result.passed = errorCode == ERR_NONE &&
+                  tests_check_value(result.expected, result.actual,
+                                    result.tolerance);
+
+  return result;
+}
+
+/**
+ * Date: Day-number round trip
+ * Every day from Jan 1, 1900 to Dec 31, 2099 must convert to consecutive
+ * day numbers (Jan 1, 1900 = day 1) and back to the same civil date.
+ * Expected mismatches = 0
+ */
+TestResult test_date_roundtrip(void) {
+  TestResult result;
+  init_test_result(&result, "Date Day# Roundtrip", "WS", 0.00, 0.0);
+
+  int mismatches = 0;
+  long expectedDays = 1;
+
+  for (int y = 1900; y <= 2099; y++) {
+    for (int m = 1; m <= 12; m++) {
+      int dim = date_days_in_month(m, y);
+      for (int d = 1; d <= dim; d++) {
+        Date in = {y, m, d};
+        Date out;
+        long days = date_to_days_since_epoch(&in);
+        date_from_days_since_epoch(days, &out);
+
+        if (days != expectedDays || out.year != y || out.month != m ||
+            out.day != d || date_to_days(y * 10000 + m * 100 + d) != days) {
+          mismatches++;
+        }
+        expectedDays++;
+      }
+    }
+  }
+
+  result.actual = (double)mismatches;
+  result.passed =
+      tests_check_value(result.expected, result.actual, result.tolerance);
+
+  return result;
+}
+
+/**
+ * TVM: Batch solver agrees with tvm_solve_for
+ * Four deals covering END/BGN, P/Y != C/Y and a zero rate, solved for
+ * PV, PMT, FV and N. Expected max |batch - single| = 0 (within 1e-6)
+ */
+TestResult test_tvm_batch(void) {
+  TestResult result;
+  init_test_result(&result, "TVM Batch vs Single", "WS", 0.00, 1e-6);
+
+  double n[] = {360, 180, 60, 120};
+  double iy[] = {5.4, 6.0, 0.0, 7.25};
+  double pv[] = {250000, 0, 12000, -50000};
+  double pmt[] = {-1403.83, -500, -200, 350};
+  double fv[] = {0, 0, 0, 10000};
+  double py[] = {12, 12, 12, 12};
+  double cy[] = {12, 12, 12, 2};
+  TVMMode mode[] = {TVM_END, TVM_BEGIN, TVM_END, TVM_BEGIN};
+  TVMVariable vars[] = {TVM_VAR_PV, TVM_VAR_PMT, TVM_VAR_FV, TVM_VAR_N};
+  double out[4];
+  int err[4];
+  double maxDiff = 0.0;
+
+  for (int v = 0; v < 4; v++) {
+    tvm_solve_batch(vars[v], n, iy, pv, pmt, fv, py, cy, mode, out, err, 4);
+
+    for (int i = 0; i < 4; i++) {
+      Calculator calc;
+      calc_init(&calc, MODEL_STANDARD);
+      calc.tvm.N = n[i];
+      calc.tvm.I_Y = iy[i];
+      calc.tvm.PV = pv[i];
+      calc.tvm.PMT = pmt[i];
+      calc.tvm.FV = fv[i];
+      calc.tvm.P_Y = py[i];
+      calc.tvm.C_Y = cy[i];
+      calc.tvm.mode = mode[i];
+
+      double single = tvm_solve_for(&calc, vars[v]);
+      double diff = fabs(out[i] - single) / (1.0 + fabs(single));
+      if (err[i] == ERR_NONE && diff > maxDiff)
+        maxDiff = diff;
+    }
+  }
+
+  result.actual = maxDiff;
+  result.passed =
+      tests_check_value(result.expected, result.actual, result.tolerance);
+
+  return result;
+}
+
+/**
+ * Bond: Warm-started yield solve
+ * 10-year 6% semi-annual bond priced at 5% YTM, then solved back from a
+ * nearby previous yield (4.8%). Expected YTM = 5.00% within 4 evaluations
+ */
+TestResult test_bond_yield_warm_start(void) {
+  TestResult result;
+  init_test_result(&result, "Bond YTM Warm Start", "WS", 5.00, 1e-6);
+
+  BondInput input = {0};
+  input.settlementDate = 20240101;
+  input.maturityDate = 20340101;
+  input.couponRate = 6.0;
+  input.redemption = 100.0;
+  input.frequency = COUPON_SEMI_ANNUAL;
+  input.dayCount = DAY_COUNT_30_360;
+
+  double price = bond_price(&input, 5.0);
+
+  int errorCode = 0;
+  int iterations = 0;
+  result.actual = bond_yield_from(&input, price, 4.8, &iterations, &errorCode);
+  result.passed = errorCode == 0 && iterations <= 4 &&
+                  tests_check_value(result.expected, result.actual,
+                                    result.tolerance);
+
+  return result;
+}
+
+/**
+ * Bond: Yield-to-call duration uses the call leg
+ * The callable bond above, at 5% YTC, must have the same duration as a
+ * 5-year bullet redeeming at 102, and the input must come back unchanged.
+ * Expected difference = 0
+ */
+TestResult test_bond_ytc_duration(void) {
+  TestResult result;
+  init_test_result(&result, "Bond YTC Duration", "WS", 0.0, 1e-9);
+
+  BondInput callable = {0};
+  callable.settlementDate = 20240101;
+  callable.maturityDate = 20340101;
+  callable.callDate = 20290101;
+  callable.callPrice = 102.0;
+  callable.couponRate = 6.0;
+  callable.redemption = 100.0;
+  callable.frequency = COUPON_SEMI_ANNUAL;
+  callable.dayCount = DAY_COUNT_30_360;
+  callable.bondType = BOND_TYPE_YTC;
+
+  BondInput bullet = callable;
+  bullet.maturityDate = callable.callDate;
+  bullet.redemption = callable.callPrice;
+  bullet.bondType = BOND_TYPE_YTM;
+
+  BondInput before = callable;
+  double ytc = bond_duration(&callable, 5.0);
+
+  result.actual = fabs(ytc - bond_duration(&bullet, 5.0));
+  result.passed =
+      memcmp(&before, &callable, sizeof(BondInput)) == 0 &&
+      tests_check_value(result.expected, result.actual, result.tolerance);
+
+  return result;
+}
+
+#include "worksheets.h"
+
+/**
+ * Worksheet: Bond outputs are cached per input generation
+ * Bond worksheet 10-year 6% semi-annual at 5% YLD; PRI is read, then the
+ * coupon is changed behind the worksheet's back (no ws_set_value), so
+ * a second read must come from the cache. Entering CPN through
+ * ws_set_value must then trigger a fresh solve.
+ * Expected PRI = 107.88 from cache
+ */
+TestResult test_ws_output_cache(void) {
+  TestResult result;
+  init_test_result(&result, "WS Output Cache", "WS", 107.88, 0.01);
+
+  Calculator calc;
+  calc_init(&calc, MODEL_PROFESSIONAL);
+  calc_reset_bond(&calc);
+
+  WorksheetState ws;
+  ws_init(&ws, WS_BOND);
+  double inputs[] = {20240101, 6.0, 20340101, 0, 100.0, 100.0, 2, 1, 5.0};
+  for (int i = 0; i < 9; i++) {
+    ws.currentIndex = i;
+    ws_set_value(&ws, &calc, inputs[i]);
+  }
+
+  ws.currentIndex = 9;
+  double first = ws_get_value(&ws, &calc);
+
+  calc.bond.couponRate = 8.0; /* Not a worksheet write: no new generation */
+  result.actual = ws_get_value(&ws, &calc);
+
+  ws.currentIndex = 1;
+  ws_set_value(&ws, &calc, 8.0);
+  ws.currentIndex = 8;
+  double yieldAfter = ws_get_value(&ws, &calc);
+
+  result.passed =
+      first == result.actual && fabs(yieldAfter - 5.0) > 0.5 &&
+      tests_check_value(result.expected, result.actual, result.tolerance);
+
+  return result;
+}
+
+/**
+ * Cash Flow: Every IRR of a non-conventional project
+ * CF0 = -100, C01 = 230, C02 = -132: two sign changes, and
+ * NPV = 0 at both 10% and 20%; cf_irr from a 25% guess takes the nearer.
+ * Expected IRRs = 10%, 20%
+ */
+TestResult test_cf_irr_multiple(void) {
+  TestResult result;
+  init_test_result(&result, "CF IRR Multiple Roots", "WS", 20.00, 0.0001);
+
+  CashFlowList cf;
+  cf_init(&cf);
+  cf_set_cf0(&cf, -100);
+  cf_add(&cf, 230, 1);
+  cf_add(&cf, -132, 1);
+
+  double roots[4];
+  int errorCode, nearError;
+  int found = cf_irr_all(&cf, roots, 4, &errorCode);
+  double nearest = cf_irr_from(&cf, 0.25, NULL, &nearError);
+
+  result.actual = (found == 2) ? roots[1] * 100.0 : 0.0;
+  result.passed = errorCode == ERR_NONE && nearError == ERR_NONE &&
+                  cf_sign_changes(&cf) == 2 && fabs(roots[0] - 0.10) < 1e-6 &&
+                  fabs(nearest - 0.20) < 1e-6 &&
+                  tests_check_value(result.expected, result.actual,
+                                    result.tolerance);
+
+  return result;
+}
+
+/**
+ * Cash Flow: Non-conventional IRR is the same after an edit and undo
+ * CF0 = -100, C01 = 230, C02 = -132 (IRRs 10% and 20%). Dropping C02 to
+ * 0 makes the IRR 130%; restoring it must give 10% again, not the root
+ * nearest the 130% left in the cache, and cf_metrics must agree.
+ * Expected IRR = 10%
+ */
+TestResult test_cf_irr_edit_undo(void) {
+  TestResult result;
+  init_test_result(&result, "CF IRR Edit/Undo", "WS", 10.00, 0.0001);
+
+  CashFlowList cf;
+  cf_init(&cf);
+  cf_set_cf0(&cf, -100);
+  cf_add(&cf, 230, 1);
+  cf_add(&cf, -132, 1);
+
+  int beforeError, editError, afterError;
+  double before = cf_irr(&cf, &beforeError);
+
+  cf_update(&cf, 1, 0, 1);
+  double edited = cf_irr(&cf, &editError);
+
+  cf_update(&cf, 1, -132, 1);
+  double after = cf_irr(&cf, &afterError);
+
+  CashFlowMetrics metrics;
+  cf_metrics(&cf, 0.10, 0.10, 0.10, &metrics);
+
+  result.actual = after * 100.0;
+  result.passed = beforeError == ERR_NONE && editError == ERR_NONE &&
+                  afterError == ERR_NONE && fabs(edited - 1.3) < 1e-9 &&
+                  after == before && metrics.irrError == ERR_NONE &&
+                  metrics.irr == after &&
+                  tests_check_value(result.expected, result.actual,
+                                    result.tolerance);
+
+  return result;
+}
+
+/**
+ * Cash Flow: IRR evaluation count on conventional projects
+ * Q5's flows, and a rental: CF0 = -250,000, C01 = 2,500 x 120 monthly,
+ * C02 = 150,000 resale. Both have one sign change; from a 10% guess
+ * cf_irr_from must need at most 5 and 8 NPV evaluations.
+ * Expected monthly IRR = 0.7975%
+ */
+TestResult test_cf_irr_evaluations(void) {
+  TestResult result;
+  init_test_result(&result, "CF IRR Evaluations", "WS", 0.7975, 0.0001);
+
+  CashFlowList project, rental;
+  cf_init(&project);
+  cf_set_cf0(&project, -50000);
+  cf_add(&project, 12000, 1);
+  cf_add(&project, 15000, 1);
+  cf_add(&project, 18000, 1);
+  cf_add(&project, 20000, 1);
+  cf_add(&project, 22000, 1);
+
+  cf_init(&rental);
+  cf_set_cf0(&rental, -250000);
+  cf_add(&rental, 2500, 120);
+  cf_add(&rental, 150000, 1);
+
+  int projectError, rentalError, projectEvaluations, rentalEvaluations;
+  cf_irr_from(&project, 0.1, &projectEvaluations, &projectError);
+  result.actual =
+      cf_irr_from(&rental, 0.1, &rentalEvaluations, &rentalError) * 100.0;
+
+  result.passed = projectError == ERR_NONE && rentalError == ERR_NONE &&
+                  projectEvaluations <= 5 && rentalEvaluations <= 8 &&
+                  tests_check_value(result.expected, result.actual,
+                                    result.tolerance);
+
+  return result;
+}
+
+/**
+ * Cash Flow: Incremental NPV after edits at the cached rate
+ * CF0 = -50,000, C01-C05 = 12k, 15k, 18k, 20k, 22k, priced at 10%, then
+ * C03 -> 25k, C05 -> 22k x3, add -5k x2, CF0 -> -60k. The updated NPV
+ * must match a list built from scratch; IRR warm-starts from 19.44%.
+ * Expected NPV = 28,664.07
+ */
+TestResult test_cf_incremental(void) {
+  TestResult result;
+  init_test_result(&result, "CF Incremental NPV", "WS", 28664.07, 0.01);
+
+  double amounts[] = {12000, 15000, 18000, 20000, 22000};
+  CashFlowList cf;
+  cf_init(&cf);
+  cf_set_cf0(&cf, -50000);
+  for (int i = 0; i < 5; i++)
+    cf_add(&cf, amounts[i], 1);
+
+  int errorCode, irrError;
+  cf_npv(&cf, 0.10);
+  double firstIrr = cf_irr(&cf, &errorCode);
+
+  cf_update(&cf, 2, 25000, 1);
+  cf_update(&cf, 4, 22000, 3);
+  cf_add(&cf, -5000, 2);
+  cf_set_cf0(&cf, -60000);
+  result.actual = cf_npv(&cf, 0.10);
+  double irr = cf_irr(&cf, &irrError);
+
+  CashFlowList fresh;
+  cf_init(&fresh);
+  cf_set_cf0(&fresh, -60000);
+  cf_add(&fresh, 12000, 1);
+  cf_add(&fresh, 15000, 1);
+  cf_add(&fresh, 25000, 1);
+  cf_add(&fresh, 20000, 1);
+  cf_add(&fresh, 22000, 3);
+  cf_add(&fresh, -5000, 2);
+
+  result.passed = errorCode == ERR_NONE && irrError == ERR_NONE &&
+                  fabs(firstIrr - 0.1944) < 1e-4 &&
+                  fabs(result.actual - cf_npv(&fresh, 0.10)) < 1e-6 &&
+                  fabs(cf_npv(&cf, irr)) < 1e-6 &&
+                  tests_check_value(result.expected, result.actual,
+                                    result.tolerance);
+
+  return result;
+}
+
+/**
+ * Cash Flow: Arena-backed series beyond MAX_CASH_FLOWS
+ * CF0 = -50,000 and 120 monthly groups of 1,000, grown from 4 slots while a
+ * second series shares the arena. Every measure must match the 32-slot
+ * list holding the same flows as one group of 1,000 x 120.
+ * Expected NPV at 1% = -50,000 + 1,000 * (1 - 1.01^-120) / 0.01 = 19,700.52
+ */
+TestResult test_cf_series(void) {
+  TestResult result;
+  init_test_result(&result, "CF Arena Series", "WS", 19700.52, 0.01);
+
+  static double buffer[1024];
+  CashFlowArena arena;
+  cf_arena_init(&arena, buffer, sizeof(buffer));
+
+  CashFlowSeries series, other;
+  int ok = cf_series_init(&series, &arena, 4) &&
+           cf_series_init(&other, &arena, 4);
+  series.CF0 = -50000;
+  for (int i = 0; i < 120 && ok; i++) {
+    ok = cf_series_add(&series, 1000, 1) >= 0 &&
+         (i % 2 || cf_series_add(&other, 2000, 1) >= 0);
+  }
+
+  CashFlowList cf;
+  cf_init(&cf);
+  cf_set_cf0(&cf, -50000);
+  cf_add(&cf, 1000, 120);
+
+  int e1, e2, e3, e4;
+  double irr = cf_series_irr(&series, 0.1, NULL, &e1);
+  double mirr = cf_series_mirr(&series, 0.01, 0.005, &e3);
+  result.actual = cf_series_npv(&series, 0.01);
+  result.passed =
+      ok && series.count == 120 && other.count == 60 &&
+      fabs(irr - cf_irr(&cf, &e2)) < 1e-9 &&
+      fabs(mirr - cf_mirr(&cf, 0.01, 0.005, &e4)) < 1e-9 &&
+      fabs(cf_series_nfv(&series, 0.01) - cf_nfv(&cf, 0.01)) < 1e-6 &&
+      fabs(cf_series_payback(&series) - cf_payback(&cf)) < 1e-9 &&
+      fabs(cf_series_discounted_payback(&series, 0.01) -
+           cf_discounted_payback(&cf, 0.01)) < 1e-9 &&
+      e1 == ERR_NONE && e3 == ERR_NONE &&
+      fabs(result.actual - cf_npv(&cf, 0.01)) < 1e-6 &&
+      tests_check_value(result.expected, result.actual, result.tolerance);
+
+  return result;
+}
+
+/**
+ * Cash Flow: NPV profile matches one cf_npv per rate
+ * CF0 = -10,000, C01 = 1,500 x5, C02 = 2,000 x1, C03 = 1,000 x12,
+ * C04 = -500 x1, C05 = 1,000 x12; 200 rates from -5% to 35%.
+ * Expected max difference = 0 (to rounding)
+ */
+TestResult test_cf_npv_profile(void) {
+  TestResult result;
+  init_test_result(&result, "CF NPV Profile", "WS", 0.0, 1e-9);
+
+  CashFlowList cf;
+  cf_init(&cf);
+  cf_set_cf0(&cf, -10000);
+  cf_add(&cf, 1500, 5);
+  cf_add(&cf, 2000, 1);
+  cf_add(&cf, 1000, 12);
+  cf_add(&cf, -500, 1);
+  cf_add(&cf, 1000, 12);
+
+  enum { POINTS = 200 };
+  double rates[POINTS], npv[POINTS];
+  for (int i = 0; i < POINTS; i++)
+    rates[i] = -0.05 + 0.40 * i / (POINTS - 1);
+  cf_npv_profile(&cf, rates, npv, POINTS);
+
+  result.actual = 0.0;
+  for (int i = 0; i < POINTS; i++) {
+    double diff = fabs(npv[i] - cf_npv(&cf, rates[i]));
+    if (diff > result.actual)
+      result.actual = diff;
+  }
+  result.passed =
+      tests_check_value(result.expected, result.actual, result.tolerance);
+
+  return result;
+}
+
+/**
+ * Cash Flow: Grouped NFV and MIRR
+ * Same flows as the NPV profile test (31 periods); NFV at I = 10%,
+ * MIRR with finance rate 8% and reinvest rate 12%.
+ * Expected MIRR = 12.0574%, NFV = 32,507.89
+ */
+TestResult test_cf_nfv_mirr(void) {
+  TestResult result;
+  init_test_result(&result, "CF NFV/MIRR Grouped", "WS", 12.0574, 0.0001);
+
+  CashFlowList cf;
+  cf_init(&cf);
+  cf_set_cf0(&cf, -10000);
+  cf_add(&cf, 1500, 5);
+  cf_add(&cf, 2000, 1);
+  cf_add(&cf, 1000, 12);
+  cf_add(&cf, -500, 1);
+  cf_add(&cf, 1000, 12);
+
+  int errorCode;
+  result.actual = cf_mirr(&cf, 0.08, 0.12, &errorCode) * 100.0;
+  result.passed =
+      errorCode == ERR_NONE &&
+      fabs(cf_nfv(&cf, 0.10) - 32507.89) < 0.01 &&
+      tests_check_value(result.expected, result.actual, result.tolerance);
+
+  return result;
+}
+
+/**
+ * Cash Flow: Dated flows (XNPV / XIRR, ACT/365)
+ * -10,000 on 01/01/2008, 2,750 on 03/01/2008, 4,250 on 10/30/2008,
+ * 3,250 on 02/15/2009, 2,750 on 04/01/2009.
+ * Expected XIRR = 37.3363%, XNPV at 9% = 2,086.65
+ */
+TestResult test_xcf_irr(void) {
+  TestResult result;
+  init_test_result(&result, "CF XIRR (Dated)", "WS", 37.3363, 0.0001);
+
+  static const int dates[] = {20080101, 20080301, 20081030, 20090215,
+                              20090401};
+  static const double amounts[] = {-10000, 2750, 4250, 3250, 2750};
+  double years[5];
+  DatedCashFlows flows;
+
+  int errorCode = xcf_load(&flows, dates, amounts, years, 5,
+                           DAY_COUNT_ACT_365);
+  double xnpv = xcf_npv(&flows, 0.09);
+  if (errorCode == ERR_NONE)
+    result.actual = xcf_irr(&flows, 0.1, NULL, &errorCode) * 100.0;
+
+  result.passed =
+      errorCode == ERR_NONE && fabs(xnpv - 2086.65) < 0.01 &&
+      tests_check_value(result.expected, result.actual, result.tolerance);
+
+  return result;
+}
+
+/**
+ * Cash Flow: Payback across a 9999-period run
+ * CF0 = -1,000,000, C01 = 150 x9999. Payback = 6,666.67 periods;
+ * discounted at 0.005% = 8,109.50, at 0.01% never (-1).
+ * Expected discounted payback at 0.005% = 8,109.505
+ */
+TestResult test_cf_payback_long(void) {
+  TestResult result;
+  init_test_result(&result, "CF Payback x9999", "WS", 8109.505, 0.001);
+
+  CashFlowList cf;
+  cf_init(&cf);
+  cf_set_cf0(&cf, -1000000);
+  cf_add(&cf, 150, 9999);
+
+  const double rates[] = {0.00005, 0.0001};
+  double discounted[2];
+  double payback = cf_payback_profile(&cf, rates, discounted, 2);
+
+  result.actual = cf_discounted_payback(&cf, 0.00005);
+  result.passed =
+      fabs(payback - 6666.6667) < 0.0001 &&
+      fabs(cf_payback(&cf) - payback) < 1e-9 &&
+      fabs(discounted[0] - result.actual) < 1e-9 && discounted[1] == -1.0 &&
+      tests_check_value(result.expected, result.actual, result.tolerance);
+
+  return result;
+}
+
+/**
+ * Cash Flow: Payback profile across two blocks of rates
+ * CF0 = -1,000, C01 = 300 x2, C02 = -100, C03 = 300 x2, C04 = 400.
+ * 40 rates from 0% to 39%: the batch walk must agree with
+ * cf_discounted_payback at each, including the rates that never recover.
+ * Expected payback = 4.6667 periods
+ */
+TestResult test_cf_payback_profile(void) {
+  TestResult result;
+  init_test_result(&result, "CF Payback Profile", "WS", 4.6667, 0.0001);
+
+  CashFlowList cf;
+  cf_init(&cf);
+  cf_set_cf0(&cf, -1000);
+  cf_add(&cf, 300, 2);
+  cf_add(&cf, -100, 1);
+  cf_add(&cf, 300, 2);
+  cf_add(&cf, 400, 1);
+
+  double rates[40], discounted[40];
+  for (int i = 0; i < 40; i++)
+    rates[i] = 0.01 * i;
+  result.actual = cf_payback_profile(&cf, rates, discounted, 40);
+
+  int same = 1, never = 0;
+  for (int i = 0; i < 40; i++) {
+    same = same &&
+           fabs(discounted[i] - cf_discounted_payback(&cf, rates[i])) < 1e-9;
+    never += discounted[i] == -1.0;
+  }
+
+  result.passed =
+      same && never > 0 && never < 40 &&
+      tests_check_value(result.expected, result.actual, result.tolerance);
+
+  return result;
+}
+
+/**
+ * Cash Flow: NPV against a zero curve
+ * Same flows as the NPV profile test; zero rates 3% (1), 4% (5),
+ * 5% (10), 5.5% (30), linear in between, flat outside. A flat 10%
+ * per-period curve must reproduce cf_npv and cf_nfv at 10%.
+ * Expected NPV = 7,935.15
+ */
+TestResult test_cf_npv_curve(void) {
+  TestResult result;
+  init_test_result(&result, "CF NPV Zero Curve", "WS", 7935.15, 0.01);
+
+  CashFlowList cf;
+  cf_init(&cf);
+  cf_set_cf0(&cf, -10000);
+  cf_add(&cf, 1500, 5);
+  cf_add(&cf, 2000, 1);
+  cf_add(&cf, 1000, 12);
+  cf_add(&cf, -500, 1);
+  cf_add(&cf, 1000, 12);
+
+  static double buffer[256];
+  CashFlowArena arena;
+  cf_arena_init(&arena, buffer, sizeof(buffer));
+
+  const double tenors[] = {1, 5, 10, 30};
+  const double zeros[] = {0.03, 0.04, 0.05, 0.055};
+  double flatRates[31];
+  for (int p = 0; p < 31; p++)
+    flatRates[p] = 0.10;
+
+  DiscountCurve zeroCurve, flatCurve;
+  int e1 = cf_curve_from_zeros(&zeroCurve, &arena, tenors, zeros, 4,
+                               CURVE_LINEAR_ZERO, 31);
+  int e2 = cf_curve_from_rates(&flatCurve, &arena, flatRates, 31);
+  int e3, e4, e5;
+
+  result.actual = cf_npv_curve(&cf, &zeroCurve, &e3);
+  double flatNpv = cf_npv_curve(&cf, &flatCurve, &e4);
+  double flatNfv = cf_nfv_curve(&cf, &flatCurve, &e5);
+
+  result.passed =
+      e1 == ERR_NONE && e2 == ERR_NONE && e3 == ERR_NONE && e4 == ERR_NONE &&
+      e5 == ERR_NONE && fabs(flatNpv - cf_npv(&cf, 0.10)) < 1e-8 &&
+      fabs(flatNfv - cf_nfv(&cf, 0.10)) < 1e-6 &&
+      tests_check_value(result.expected, result.actual, result.tolerance);
+
+  return result;
+}
+
+/**
+ * TVM: I/Y for a 30-year mortgage
+ * N=360, PV=100,000, PMT=-536.82, FV=0 (END). The closed-form seed
+ * lands close enough for Halley to finish in a few evaluations. A
+ * BGN-mode balloon loan priced at 0.5%/month must solve back to it.
+ * Expected I/Y = 5.00% (annual, 12 periods)
+ */
+TestResult test_tvm_iy_mortgage(void) {
+  TestResult result;
+  init_test_result(&result, "TVM I/Y Mortgage", "TVM", 5.00, 0.001);
+
+  int errorCode, iterations, balloonError;
+  double rate = tvm_calc_iy_from(360, 100000, -536.82, 0, TVM_END, -1.0,
+                                 &iterations, &errorCode);
+  result.actual = rate * 1200.0;
+
+  double pmt = tvm_calc_pmt(60, 0.005, 20000, -5000, TVM_BEGIN);
+  double balloon = tvm_calc_iy(60, 20000, pmt, -5000, TVM_BEGIN,
+                               &balloonError);
+
+  result.passed = errorCode == ERR_NONE && iterations <= 4 &&
+                  balloonError == ERR_NONE &&
+                  fabs(balloon - 0.005) < 1e-10 &&
+                  tests_check_value(result.expected, result.actual,
+                                    result.tolerance);
+
+  return result;
+}
+
+/**
+ * TVM: Rate x term grid matches per-cell solves
+ * PV=300,000 over 0%, 5% and 6% (monthly) x 10/15/20/30/30-year terms,
+ * balance after 60 payments. Every cell must match tvm_calc_pmt and
+ * the amortization balance.
+ * Expected PMT (6%, 360) = -1,798.65
+ */
+TestResult test_tvm_grid(void) {
+  TestResult result;
+  init_test_result(&result, "TVM Rate x Term Grid", "TVM", -1798.65, 0.01);
+
+  const double rates[] = {0.0, 0.05 / 12, 0.06 / 12};
+  const int terms[] = {120, 180, 240, 360, 360};
+  enum { RATES = 3, TERMS = 5 };
+  TVMGrid grid = {rates, RATES, terms, TERMS, 300000, 0, TVM_END, 60};
+  double pmt[RATES * TERMS], balance[RATES * TERMS];
+
+  int errorCode = tvm_grid(&grid, pmt, balance);
+
+  double maxDiff = 0.0;
+  for (int t = 0; t < TERMS; t++) {
+    for (int r = 0; r < RATES; r++) {
+      double p = tvm_calc_pmt(terms[t], rates[r], 300000, 0, TVM_END);
+      AmortResult row = tvm_amort_period(60, terms[t], rates[r], 300000,
+                                         pmt[t * RATES + r]);
+      double d = fabs(pmt[t * RATES + r] - p) +
+                 fabs(balance[t * RATES + r] - row.balance) * 1e-3;
+      if (d > maxDiff)
+        maxDiff = d;
+    }
+  }
+
+  result.actual = pmt[3 * RATES + 2];
+  result.passed =
+      errorCode == ERR_NONE && maxDiff < 1e-8 &&
+      tests_check_value(result.expected, result.actual, result.tolerance);
+
+  return result;
+}
+
+/**
+ * TVM: Solving PMT, PV, FV on one deal reuses the cached factors
+ * N=360, I/Y=6% compounded quarterly, P/Y=12, PV=250,000. The rate
+ * conversion and (1+i)^N cost one power each across all three solves
+ * (counted on the host build); storing a new N must refresh the
+ * compound factor.
+ * Expected PMT = -1,494.10
+ */
+TestResult test_tvm_factor_cache(void) {
+  TestResult result;
+  init_test_result(&result, "TVM Factor Cache", "TVM", -1494.10, 0.01);
+
+  Calculator calc;
+  calc_init(&calc, MODEL_STANDARD);
+  calc.tvm.N = 360;
+  calc.tvm.I_Y = 6;
+  calc.tvm.PV = 250000;
+  calc.tvm.FV = 0;
+  calc.tvm.P_Y = 12;
+  calc.tvm.C_Y = 4;
+
+#ifdef TEST_BUILD
+  FinPowCounts counts;
+  fin_pow_counts(&counts, 1);
+#endif
+
+  result.actual = tvm_solve_for(&calc, TVM_VAR_PMT);
+  double fv = tvm_solve_for(&calc, TVM_VAR_FV);
+  double pv = tvm_solve_for(&calc, TVM_VAR_PV);
+  int cached = calc.tvm.cache.valid && calc.tvm.cache.N == 360;
+
+  int onePowerEach = 1;
+#ifdef TEST_BUILD
+  fin_pow_counts(&counts, 1);
+  onePowerEach = (counts.binary + counts.transcendental == 2);
+#endif
+
+  double rate = tvm_periodic_rate(6, 12, 4);
+  tvm_store(&calc, TVM_VAR_N, 240);
+  double pmt240 = tvm_solve_for(&calc, TVM_VAR_PMT);
+
+  result.passed =
+      cached && onePowerEach && fabs(fv) < 1e-6 && fabs(pv - 250000) < 1e-6 &&
+      fabs(pmt240 - tvm_calc_pmt(240, rate, 250000, 0, TVM_END)) < 1e-9 &&
+      tests_check_value(result.expected, result.actual, result.tolerance);
+
+  return result;
+}
+
+#ifdef TEST_BUILD
+#include "portfolio.h"
+
+/**
+ * Bond: Threaded portfolio matches serial bond_calculate
+ * 1000 mixed bonds (YTM and YTC, priced and yield-solved) on 4 threads.
+ * Expected max difference = 0 (host build only)
+ */
+TestResult test_bond_portfolio(void) {
+  TestResult result;
+  init_test_result(&result, "Bond Portfolio x4", "WS", 0.0, 1e-12);
+
+  enum { BOOK = 1000 };
+  static BondInput bonds[BOOK];
+  static double prices[BOOK];
+  static double yields[BOOK];
+  static BondResult results[BOOK];
+  static int errors[BOOK];
+
+  for (int i = 0; i < BOOK; i++) {
+    BondInput *b = &bonds[i];
+    memset(b, 0, sizeof(BondInput));
+    b->settlementDate = 20240101;
+    b->maturityDate = (2025 + i % 30) * 10000 + 101;
+    b->callDate = 20270101;
+    b->callPrice = 101.0;
+    b->couponRate = (i % 17) * 0.5;
+    b->redemption = 100.0;
+    b->frequency = (i % 3) ? COUPON_SEMI_ANNUAL : COUPON_ANNUAL;
+    b->dayCount = DAY_COUNT_30_360;
+    b->bondType = (i % 5 == 0 && i % 30 > 3) ? BOND_TYPE_YTC : BOND_TYPE_YTM;
+    yields[i] = 1.0 + (i % 13) * 0.5;
+    prices[i] = (i % 2) ? bond_price(b, yields[i] + 0.25) : 0.0;
+  }
+
+  int solved = portfolio_calculate(bonds, prices, yields, results, errors,
+                                   BOOK, 4);
+
+  double maxDiff = 0.0;
+  for (int i = 0; i < BOOK; i++) {
+    BondResult ref = bond_calculate(&bonds[i], prices[i], yields[i], NULL);
+    double d = fabs(ref.price - results[i].price) +
+               fabs(ref.yield - results[i].yield) +
+               fabs(ref.duration - results[i].duration) +
+               fabs(ref.modDuration - results[i].modDuration);
+    if (d > maxDiff)
+      maxDiff = d;
+  }
+
+  result.actual = maxDiff;
+  result.passed =
+      solved == BOOK &&
+      tests_check_value(result.expected, result.actual, result.tolerance);
+
+  return result;
+}
+
+/**
+ * Cash Flow: Threaded project screen matches serial cf_metrics
+ * 1000 projects on 4 threads; every 7th has no sign change and must
+ * report ERR_NO_SOLUTION. Expected max difference = 0 (host build only)
+ */
+TestResult test_cf_portfolio(void) {
+  TestResult result;
+  init_test_result(&result, "CF Portfolio x4", "WS", 0.0, 1e-12);
+
+  enum { BOOK = 1000 };
+  static CashFlowList projects[BOOK];
+  static CashFlowMetrics metrics[BOOK];
+  static int errors[BOOK];
+
+  for (int i = 0; i < BOOK; i++) {
+    CashFlowList *cf = &projects[i];
+    cf_init(cf);
+    cf_set_cf0(cf, (i % 7 == 0) ? 500.0 : -1000.0 - (i % 50) * 20.0);
+    cf_add(cf, 100.0 + (i % 11) * 15.0, 1 + i % 9);
+    cf_add(cf, 250.0, 1 + i % 4);
+    if (i % 5 == 0)
+      cf_add(cf, -300.0, 1);
+    cf_add(cf, 150.0 + (i % 13) * 10.0, 2 + i % 6);
+  }
+
+  int solved = portfolio_cashflow(projects, 0.08, 0.06, 0.10, metrics, errors,
+                                  BOOK, 4);
+
+  double maxDiff = 0.0;
+  int expectedSolved = 0, codesMatch = 1;
+  for (int i = 0; i < BOOK; i++) {
+    CashFlowMetrics ref;
+    int code = cf_metrics(&projects[i], 0.08, 0.06, 0.10, &ref);
+    double d = fabs(ref.npv - metrics[i].npv) +
+               fabs(ref.irr - metrics[i].irr) +
+               fabs(ref.mirr - metrics[i].mirr) +
+               fabs(ref.payback - metrics[i].payback) +
+               fabs(ref.discountedPayback - metrics[i].discountedPayback);
+    if (d > maxDiff)
+      maxDiff = d;
+    if (code != errors[i] || (i % 7 == 0) != (code == ERR_NO_SOLUTION))
+      codesMatch = 0;
+    expectedSolved += (code == ERR_NONE);
+  }
+
+  result.actual = maxDiff;
+  result.passed =
+      solved == expectedSolved && codesMatch &&
+      tests_check_value(result.expected, result.actual, result.tolerance);
+
+  return result;
+}
+
+/**
+ * TVM: Threaded rate sheet matches the serial grid
+ * 400 rates x 40 annual terms (BGN, 10% balloon) on 4 threads, balance
+ * after 84 payments. Expected max difference = 0 (host build only)
+ */
+TestResult test_tvm_grid_threads(void) {
+  TestResult result;
+  init_test_result(&result, "TVM Grid x4", "TVM", 0.0, 1e-12);
+
+  enum { RATES = 400, TERMS = 40 };
+  static double rates[RATES];
+  static int terms[TERMS];
+  static double pmt[RATES * TERMS], balance[RATES * TERMS];
+  static double refPmt[RATES * TERMS], refBalance[RATES * TERMS];
+
+  for (int r = 0; r < RATES; r++)
+    rates[r] = (1.0 + r * 0.025) / 1200.0;
+  for (int t = 0; t < TERMS; t++)
+    terms[t] = 12 * (t + 1);
+
+  TVMGrid grid = {rates, RATES, terms, TERMS, 250000, -25000, TVM_BEGIN, 84};
+  int e1 = portfolio_tvm_grid(&grid, pmt, balance, 4);
+  int e2 = tvm_grid(&grid, refPmt, refBalance);
+
+  double maxDiff = 0.0;
+  for (int k = 0; k < RATES * TERMS; k++) {
+    double d = fabs(pmt[k] - refPmt[k]) + fabs(balance[k] - refBalance[k]);
+    if (d > maxDiff)
+      maxDiff = d;
+  }
+
+  terms[1] = 6; /* Out of order: rejected */
+  int e3 = portfolio_tvm_grid(&grid, pmt, balance, 4);
+
+  result.actual = maxDiff;
+  result.passed =
+      e1 == ERR_NONE && e2 == ERR_NONE && e3 == ERR_INVALID_INPUT &&
+      tests_check_value(result.expected, result.actual, result.tolerance);
+
+  return result;
+}
+#endif /* TEST_BUILD */
+
 void tests_run_all(TestSuite *suite) {
   memset(suite, 0, sizeof(TestSuite));
 
@@ -1276,6 +2335,35 @@ void tests_run_all(TestSuite *suite) {
   suite->results[suite->total++] = test_date_diff_360();
   suite->results[suite->total++] = test_regression_linear();
   suite->results[suite->total++] = test_bond_callable();
+  suite->results[suite->total++] = test_cf_grouped_npv();
+  suite->results[suite->total++] = test_cf_grouped_irr();
+  suite->results[suite->total++] = test_date_roundtrip();
+  suite->results[suite->total++] = test_tvm_batch();
+  suite->results[suite->total++] = test_bond_yield_warm_start();
+  suite->results[suite->total++] = test_bond_ytc_duration();
+  suite->results[suite->total++] = test_amort_schedule_stream();
+  suite->results[suite->total++] = test_depreciation_schedule();
+  suite->results[suite->total++] = test_statistics_welford();
+  suite->results[suite->total++] = test_ws_output_cache();
+  suite->results[suite->total++] = test_cf_irr_multiple();
+  suite->results[suite->total++] = test_cf_irr_evaluations();
+  suite->results[suite->total++] = test_cf_irr_edit_undo();
+  suite->results[suite->total++] = test_cf_incremental();
+  suite->results[suite->total++] = test_cf_series();
+  suite->results[suite->total++] = test_cf_npv_profile();
+  suite->results[suite->total++] = test_cf_nfv_mirr();
+  suite->results[suite->total++] = test_xcf_irr();
+  suite->results[suite->total++] = test_cf_payback_long();
+  suite->results[suite->total++] = test_cf_payback_profile();
+  suite->results[suite->total++] = test_cf_npv_curve();
+  suite->results[suite->total++] = test_tvm_iy_mortgage();
+  suite->results[suite->total++] = test_tvm_grid();
+  suite->results[suite->total++] = test_tvm_factor_cache();
+#ifdef TEST_BUILD
+  suite->results[suite->total++] = test_bond_portfolio();
+  suite->results[suite->total++] = test_cf_portfolio();
+  suite->results[suite->total++] = test_tvm_grid_threads();
+#endif
 
   /* Count results */
   suite->passed = 0;
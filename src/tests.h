@@ -27,7 +27,7 @@ typedef struct {
   int total;              /* Total tests run */
   int passed;             /* Tests passed */
   int failed;             /* Tests failed */
-  TestResult results[50]; /* Individual results - increased for new tests */
+  TestResult results[80]; /* Individual results - increased for new tests */
 } TestSuite;
 
 /* ============================================================
@@ -8,7 +8,10 @@
 
 #include "tvm.h"
 #include "config.h"
+#include "finmath.h"
+#include <float.h>
 #include <math.h>
+#include <stddef.h>
 
 /* ============================================================
  * Helper Functions
@@ -35,28 +38,124 @@ double tvm_periodic_rate(double annualRate, double py, double cy) {
   } else {
     /* Rate conversion */
     double nominalRate = annualRate / 100.0;
-    rate = pow(1.0 + nominalRate / cy, cy / py) - 1.0;
+    rate = fin_powm1(nominalRate / cy, cy / py);
   }
 
   return rate;
 }
 
+/* ============================================================
+ * Closed Forms
+ * Given the compound factor (1+i)^n or discount (1+i)^-n, so the
+ * tvm_calc_* entry points and tvm_solve_for's cache share them.
+ * ============================================================ */
+
+static double tvm_fv_from(double n, double rate, double compoundFactor,
+                          double pv, double pmt, TVMMode mode) {
+  /*
+   * FV = -( PV * (1+i)^n + PMT * [(1+i)^n - 1] / i * (1+i*k) )
+   * where k = 1 for BEGIN mode, k = 0 for END mode
+   * 
+   * OPTIMIZED: Reuse compoundFactor, avoid redundant calculations
+   */
+
+  if (rate == 0.0) {
+    /* Simple case: no interest */
+    return -(pv + pmt * n);
+  }
+
+  double annuityFactor = (compoundFactor - 1.0) / rate;
+  
+  /* BGN mode multiplier: (1+i) for BEGIN, 1 for END */
+  double modeMultiplier = (mode == TVM_BEGIN) ? (1.0 + rate) : 1.0;
+
+  return -(pv * compoundFactor + pmt * annuityFactor * modeMultiplier);
+}
+
+static double tvm_pv_from(double n, double rate, double discountFactor,
+                          double pmt, double fv, TVMMode mode) {
+  /*
+   * PV = -( FV / (1+i)^n + PMT * [1 - (1+i)^(-n)] / i * (1+i*k) )
+   */
+
+  if (rate == 0.0) {
+    return -(fv + pmt * n);
+  }
+
+  double annuityFactor = (1.0 - discountFactor) / rate;
+  double modeMultiplier = (mode == TVM_BEGIN) ? (1.0 + rate) : 1.0;
+
+  return -(fv * discountFactor + pmt * annuityFactor * modeMultiplier);
+}
+
+static double tvm_pmt_from(double n, double rate, double discountFactor,
+                           double pv, double fv, TVMMode mode) {
+  /*
+   * PMT = -(PV + FV/(1+i)^n) / ( [1-(1+i)^(-n)]/i * (1+i*k) )
+   */
+
+  if (rate == 0.0) {
+    if (n == 0.0)
+      return 0.0;
+    return -(pv + fv) / n;
+  }
+
+  double annuityFactor = (1.0 - discountFactor) / rate;
+  double modeMultiplier = (mode == TVM_BEGIN) ? (1.0 + rate) : 1.0;
+
+  return -(pv + fv * discountFactor) / (annuityFactor * modeMultiplier);
+}
+
+/* ============================================================
+ * Factor Cache
+ * ============================================================ */
+
+/* Periodic rate, recomputed only when I/Y, P/Y or C/Y changed */
+static double tvm_cached_rate(TVM_Data *tvm) {
+  TVMCache *cache = &tvm->cache;
+
+  if (!cache->valid || cache->I_Y != tvm->I_Y || cache->P_Y != tvm->P_Y ||
+      cache->C_Y != tvm->C_Y) {
+    cache->rate = tvm_periodic_rate(tvm->I_Y, tvm->P_Y, tvm->C_Y);
+    cache->I_Y = tvm->I_Y;
+    cache->P_Y = tvm->P_Y;
+    cache->C_Y = tvm->C_Y;
+    cache->N = NAN; /* Compound factor belongs to the old rate */
+    cache->valid = 1;
+  }
+
+  return cache->rate;
+}
+
+/* Rate plus (1+i)^N and (1+i)^-N, recomputed when any key field changed */
+static const TVMCache *tvm_cached_factors(TVM_Data *tvm) {
+  TVMCache *cache = &tvm->cache;
+  double rate = tvm_cached_rate(tvm);
+
+  if (cache->N != tvm->N) {
+    cache->compound = (rate == 0.0) ? 1.0 : fin_powi(rate, tvm->N);
+    cache->discount = 1.0 / cache->compound;
+    cache->N = tvm->N;
+  }
+
+  return cache;
+}
+
 /* ============================================================
  * TVM Solver - Main Entry Point
  * ============================================================ */
 
 double tvm_solve_for(Calculator *calc, TVMVariable solveFor) {
   TVM_Data *tvm = &calc->tvm;
-
-  /* Get periodic interest rate */
-  double rate = tvm_periodic_rate(tvm->I_Y, tvm->P_Y, tvm->C_Y);
+  const TVMCache *factors;
 
   double result = 0.0;
   calc->errorCode = ERR_NONE;
 
   switch (solveFor) {
   case TVM_VAR_N:
-    result = tvm_calc_n(rate, tvm->PV, tvm->PMT, tvm->FV, tvm->mode);
+    result = tvm_calc_n(tvm_cached_rate(tvm), tvm->PV, tvm->PMT, tvm->FV,
+                        tvm->mode);
     tvm->N = result;
     break;
 
@@ -71,17 +170,23 @@ double tvm_solve_for(Calculator *calc, TVMVariable solveFor) {
     break;
 
   case TVM_VAR_PV:
-    result = tvm_calc_pv(tvm->N, rate, tvm->PMT, tvm->FV, tvm->mode);
+    factors = tvm_cached_factors(tvm);
+    result = tvm_pv_from(tvm->N, factors->rate, factors->discount, tvm->PMT,
+                         tvm->FV, tvm->mode);
     tvm->PV = result;
     break;
 
   case TVM_VAR_PMT:
-    result = tvm_calc_pmt(tvm->N, rate, tvm->PV, tvm->FV, tvm->mode);
+    factors = tvm_cached_factors(tvm);
+    result = tvm_pmt_from(tvm->N, factors->rate, factors->discount, tvm->PV,
+                          tvm->FV, tvm->mode);
     tvm->PMT = result;
     break;
 
   case TVM_VAR_FV:
-    result = tvm_calc_fv(tvm->N, rate, tvm->PV, tvm->PMT, tvm->mode);
+    factors = tvm_cached_factors(tvm);
+    result = tvm_fv_from(tvm->N, factors->rate, factors->compound, tvm->PV,
+                         tvm->PMT, tvm->mode);
     tvm->FV = result;
     break;
 
@@ -94,67 +199,206 @@ double tvm_solve_for(Calculator *calc, TVMVariable solveFor) {
 }
 
 /* ============================================================
- * Individual TVM Functions
+ * Batch TVM Solver (structure-of-arrays)
  * ============================================================ */
 
-double tvm_calc_fv(double n, double rate, double pv, double pmt, TVMMode mode) {
-  /*
-   * FV = -( PV * (1+i)^n + PMT * [(1+i)^n - 1] / i * (1+i*k) )
-   * where k = 1 for BEGIN mode, k = 0 for END mode
-   * 
-   * OPTIMIZED: Reuse compoundFactor, avoid redundant calculations
-   */
+/* Deals per chunk: bounds the stack scratch (1.5 KB on the device) */
+#define TVM_BATCH_CHUNK 64
 
-  if (rate == 0.0) {
-    /* Simple case: no interest */
-    return -(pv + pmt * n);
+/*
+ * Each chunk is processed in passes:
+ *   1. periodic rate (pow only where P/Y != C/Y)
+ *   2. scalar pass for the per-deal factors, which depend only on N,
+ *      the rate and the mode: (1+i)^(+/-n) (exp/log1p: on random
+ *      terms that beats fin_powi's data-dependent squaring loop) and
+ *      the annuity factor times the BGN multiplier
+ *   3. the amounts: plain multiply-adds with no calls or branches, which
+ *      the compiler can vectorize without -ffast-math or a vector math
+ *      library (GCC does at -O3; the -O2 "very cheap" cost model skips
+ *      loops whose trip count is only known at run time)
+ *
+ * Solving N is the other way round: the arithmetic pass forms the
+ * ratio's numerator and denominator, then a scalar pass takes the logs.
+ */
+
+/*
+ * Pass 2. For FV/PV, scale[j] is the annuity factor times the BGN
+ * multiplier; for PMT (invert) it is the reciprocal, or 0 where that
+ * is zero (N == 0 at i == 0, matching tvm_calc_pmt).
+ */
+static void tvm_batch_factors(const double n[], const double rate[],
+                              const TVMMode mode[], double sign, int invert,
+                              double factor[], double scale[], int len) {
+  for (int j = 0; j < len; j++) {
+    double r = rate[j];
+    double annuityFactor;
+
+    if (r == 0.0) {
+      factor[j] = 1.0;
+      annuityFactor = n[j];
+    } else {
+      factor[j] = exp(sign * n[j] * log1p(r));
+      annuityFactor = sign * (factor[j] - 1.0) / r;
+    }
+
+    if (mode[j] == TVM_BEGIN)
+      annuityFactor *= 1.0 + r;
+
+    if (invert)
+      scale[j] = (annuityFactor == 0.0) ? 0.0 : 1.0 / annuityFactor;
+    else
+      scale[j] = annuityFactor;
   }
+}
 
-  double compoundFactor = pow(1.0 + rate, n);
-  double annuityFactor = (compoundFactor - 1.0) / rate;
-  
-  /* BGN mode multiplier: (1+i) for BEGIN, 1 for END */
-  double modeMultiplier = (mode == TVM_BEGIN) ? (1.0 + rate) : 1.0;
+/*
+ * Pass 3 kernels: factor[] and scale[] come from tvm_batch_factors.
+ * The outputs never alias the inputs, which restrict tells the compiler
+ * so it need not version the loops.
+ */
 
-  return -(pv * compoundFactor + pmt * annuityFactor * modeMultiplier);
+static void tvm_batch_fv(const double *restrict compound,
+                         const double *restrict scale,
+                         const double *restrict pv,
+                         const double *restrict pmt, double *restrict out,
+                         int len) {
+  for (int j = 0; j < len; j++)
+    out[j] = -(pv[j] * compound[j] + pmt[j] * scale[j]);
 }
 
-double tvm_calc_pv(double n, double rate, double pmt, double fv, TVMMode mode) {
-  /*
-   * PV = -( FV / (1+i)^n + PMT * [1 - (1+i)^(-n)] / i * (1+i*k) )
-   * 
-   * OPTIMIZED: Single pow() call, reuse discountFactor
-   */
+static void tvm_batch_pv(const double *restrict discount,
+                         const double *restrict scale,
+                         const double *restrict pmt,
+                         const double *restrict fv, double *restrict out,
+                         int len) {
+  for (int j = 0; j < len; j++)
+    out[j] = -(fv[j] * discount[j] + pmt[j] * scale[j]);
+}
 
-  if (rate == 0.0) {
-    return -(fv + pmt * n);
+static void tvm_batch_pmt(const double *restrict discount,
+                          const double *restrict inverse,
+                          const double *restrict pv,
+                          const double *restrict fv, double *restrict out,
+                          int len) {
+  for (int j = 0; j < len; j++)
+    out[j] = -(pv[j] + fv[j] * discount[j]) * inverse[j];
+}
+
+static void tvm_batch_n(const double rate[], const double pv[],
+                        const double pmt[], const double fv[],
+                        const TVMMode mode[], double numerator[],
+                        double denominator[], double out[], int err[],
+                        int len) {
+  /* Arithmetic pass; TVM_BEGIN is 1 and TVM_END 0 */
+  for (int j = 0; j < len; j++) {
+    double pmtAdj = pmt[j] * (1.0 + rate[j] * (double)mode[j]);
+    numerator[j] = pmtAdj - fv[j] * rate[j];
+    denominator[j] = pmtAdj + pv[j] * rate[j];
   }
 
-  double discountFactor = pow(1.0 + rate, -n);
-  double annuityFactor = (1.0 - discountFactor) / rate;
-  double modeMultiplier = (mode == TVM_BEGIN) ? (1.0 + rate) : 1.0;
+  for (int j = 0; j < len; j++) {
+    double ratio = (denominator[j] == 0.0) ? 0.0 : numerator[j] / denominator[j];
+    int valid;
 
-  return -(fv * discountFactor + pmt * annuityFactor * modeMultiplier);
+    if (rate[j] == 0.0) {
+      valid = (pmt[j] != 0.0);
+      out[j] = valid ? -(pv[j] + fv[j]) / pmt[j] : 0.0;
+    } else {
+      valid = (ratio > 0.0);
+      out[j] = valid ? log(ratio) / log1p(rate[j]) : 0.0;
+    }
+    err[j] = valid ? ERR_NONE : ERR_NO_SOLUTION;
+  }
 }
 
-double tvm_calc_pmt(double n, double rate, double pv, double fv, TVMMode mode) {
-  /*
-   * PMT = -(PV + FV/(1+i)^n) / ( [1-(1+i)^(-n)]/i * (1+i*k) )
-   * 
-   * OPTIMIZED: Single pow() call
-   */
+int tvm_solve_batch(TVMVariable solveFor, const double n[], const double iy[],
+                    const double pv[], const double pmt[], const double fv[],
+                    const double py[], const double cy[], const TVMMode mode[],
+                    double out[], int err[], int count) {
+  double rate[TVM_BATCH_CHUNK];
+  double factor[TVM_BATCH_CHUNK]; /* (1+i)^(+/-n), or N's numerator */
+  double scale[TVM_BATCH_CHUNK];  /* Annuity scale, or N's denominator */
+  int solved = 0;
+
+  if (solveFor == TVM_VAR_IY) {
+    /* Iterative: no closed form, solve deal by deal */
+    for (int i = 0; i < count; i++) {
+      double r = tvm_calc_iy(n[i], pv[i], pmt[i], fv[i], mode[i], &err[i]);
+      out[i] = (err[i] == ERR_NONE) ? r * 100.0 * py[i] : 0.0;
+      solved += (err[i] == ERR_NONE);
+    }
+    return solved;
+  }
 
-  if (rate == 0.0) {
-    if (n == 0.0)
-      return 0.0;
-    return -(pv + fv) / n;
+  for (int base = 0; base < count; base += TVM_BATCH_CHUNK) {
+    int len = count - base;
+    if (len > TVM_BATCH_CHUNK)
+      len = TVM_BATCH_CHUNK;
+
+    for (int j = 0; j < len; j++) {
+      rate[j] = tvm_periodic_rate(iy[base + j], py[base + j], cy[base + j]);
+    }
+
+    switch (solveFor) {
+    case TVM_VAR_N:
+      tvm_batch_n(rate, pv + base, pmt + base, fv + base, mode + base, factor,
+                  scale, out + base, err + base, len);
+      break;
+    case TVM_VAR_PV:
+      tvm_batch_factors(n + base, rate, mode + base, -1.0, 0, factor, scale,
+                        len);
+      tvm_batch_pv(factor, scale, pmt + base, fv + base, out + base, len);
+      break;
+    case TVM_VAR_PMT:
+      tvm_batch_factors(n + base, rate, mode + base, -1.0, 1, factor, scale,
+                        len);
+      tvm_batch_pmt(factor, scale, pv + base, fv + base, out + base, len);
+      break;
+    case TVM_VAR_FV:
+      tvm_batch_factors(n + base, rate, mode + base, 1.0, 0, factor, scale,
+                        len);
+      tvm_batch_fv(factor, scale, pv + base, pmt + base, out + base, len);
+      break;
+    default:
+      for (int j = 0; j < len; j++) {
+        out[base + j] = 0.0;
+        err[base + j] = ERR_INVALID_INPUT;
+      }
+      continue;
+    }
+
+    if (solveFor != TVM_VAR_N) {
+      for (int j = 0; j < len; j++) {
+        err[base + j] = ERR_NONE;
+      }
+    }
+
+    for (int j = 0; j < len; j++) {
+      solved += (err[base + j] == ERR_NONE);
+    }
   }
 
-  double discountFactor = pow(1.0 + rate, -n);
-  double annuityFactor = (1.0 - discountFactor) / rate;
-  double modeMultiplier = (mode == TVM_BEGIN) ? (1.0 + rate) : 1.0;
+  return solved;
+}
 
-  return -(pv + fv * discountFactor) / (annuityFactor * modeMultiplier);
+/* ============================================================
+ * Individual TVM Functions
+ * ============================================================ */
+
+double tvm_calc_fv(double n, double rate, double pv, double pmt, TVMMode mode) {
+  double compoundFactor = (rate == 0.0) ? 1.0 : fin_powi(rate, n);
+  return tvm_fv_from(n, rate, compoundFactor, pv, pmt, mode);
+}
+
+double tvm_calc_pv(double n, double rate, double pmt, double fv, TVMMode mode) {
+  /* Single fin_powi() call, reused for both terms */
+  double discountFactor = (rate == 0.0) ? 1.0 : fin_powi(rate, -n);
+  return tvm_pv_from(n, rate, discountFactor, pmt, fv, mode);
+}
+
+double tvm_calc_pmt(double n, double rate, double pv, double fv, TVMMode mode) {
+  double discountFactor = (rate == 0.0) ? 1.0 : fin_powi(rate, -n);
+  return tvm_pmt_from(n, rate, discountFactor, pv, fv, mode);
 }
 
 double tvm_calc_n(double rate, double pv, double pmt, double fv, TVMMode mode) {
@@ -184,130 +428,310 @@ double tvm_calc_n(double rate, double pv, double pmt, double fv, TVMMode mode) {
 }
 
 /* ============================================================
- * Newton-Raphson Method for I/Y (OPTIMIZED)
+ * I/Y Solver (Halley with Brent fallback)
  * ============================================================ */
 
+#define IY_MIN -0.999       /* Periodic rate search range */
+#define IY_MAX 10.0
+#define IY_SMALL_NI 1e-4    /* Below this |n*i|, A and its slopes use series */
+#define IY_EXPAND_STEP 0.01 /* First probe distance when bracketing */
+
+typedef struct {
+  double n;
+  double pv;
+  double pmt;
+  double fv;
+  int begin; /* 1 in BGN mode */
+} IYProblem;
+
 /*
- * The TVM equation: PV + PMT * A + FV * D = 0
+ * The TVM equation: f(i) = PV + PMT * M * A + FV * D = 0
  * where:
- *   D = (1+i)^(-n)           (discount factor)
- *   A = (1-D)/i * M          (annuity factor, M = mode multiplier)
+ *   D = (1+i)^(-n)           D'  = -n D / (1+i)   D'' = n(n+1) D / (1+i)^2
+ *   A = (1-D)/i              A'  = -(D' + A) / i  A'' = -(D'' + 2A') / i
+ *   M = 1+i in BGN, else 1
  *
- * OPTIMIZATION: Compute function and derivative together to reuse
- * intermediate values and avoid redundant pow() calls.
+ * One fin_powi gives f and both derivatives. A and its slopes cancel
+ * badly when n*i is tiny, so a short Taylor series is used there.
  */
+static void tvm_iy_eval(const IYProblem *p, double rate, double *f,
+                        double *df, double *d2f) {
+  double n = p->n;
+  double onePlusRate = 1.0 + rate;
+  double D = fin_powi(rate, -n);
+  double dD = -n * D / onePlusRate;
+  double d2D = n * (n + 1.0) * D / (onePlusRate * onePlusRate);
+  double A, dA, d2A;
+
+  if (fabs(n * rate) < IY_SMALL_NI) {
+    double s1 = n * (n + 1.0) / 2.0;
+    double s2 = s1 * (n + 2.0) / 3.0;
+    A = n - s1 * rate + s2 * rate * rate;
+    dA = -s1 + 2.0 * s2 * rate;
+    d2A = 2.0 * s2;
+  } else {
+    A = (1.0 - D) / rate;
+    dA = -(dD + A) / rate;
+    d2A = -(d2D + 2.0 * dA) / rate;
+  }
 
-static void tvm_function_and_derivative(double rate, double n, double pv,
-                                        double pmt, double fv, double modeMultiplier,
-                                        double *f, double *df) {
-  if (rate == 0.0) {
-    *f = pv + pmt * n + fv;
-    *df = 0.0;
-    return;
+  /* g = M * A */
+  double g = A, dg = dA, d2g = d2A;
+  if (p->begin) {
+    g = onePlusRate * A;
+    dg = A + onePlusRate * dA;
+    d2g = 2.0 * dA + onePlusRate * d2A;
   }
 
-  /* Compute powers once */
-  double onePlusRate = 1.0 + rate;
-  double compFactor = pow(onePlusRate, n);     /* (1+i)^n */
-  double discFactor = 1.0 / compFactor;         /* (1+i)^(-n) */
-  
-  /* Annuity factor: (1 - D) / i * M */
-  double annuityFactor = (1.0 - discFactor) / rate * modeMultiplier;
-  
-  /* Function value: f(i) = PV + PMT*A + FV*D */
-  *f = pv + pmt * annuityFactor + fv * discFactor;
-  
-  /*
-   * ANALYTICAL DERIVATIVE (much faster than numerical):
-   * 
-   * d(discFactor)/di = -n * (1+i)^(-n-1) = -n * D / (1+i)
-   * 
-   * For annuity factor A = (1-D)/i * M:
-   * dA/di = M * [(-dD/di * i - (1-D)) / i^2]
-   *       = M * [(n*D/(1+i) * i - (1-D)) / i^2]
-   *       = M * [(n*D*i/(1+i) - 1 + D) / i^2]
-   * 
-   * df/di = PMT * dA/di + FV * dD/di
-   */
-  double dDisc = -n * discFactor / onePlusRate;
-  double dAnnuity = modeMultiplier * (n * discFactor * rate / onePlusRate - 1.0 + discFactor) / (rate * rate);
-  
-  *df = pmt * dAnnuity + fv * dDisc;
+  *f = p->pv + p->pmt * g + p->fv * D;
+  *df = p->pmt * dg + p->fv * dD;
+  *d2f = p->pmt * d2g + p->fv * d2D;
 }
 
-double tvm_calc_iy(double n, double pv, double pmt, double fv, TVMMode mode,
-                   int *errorCode) {
-  double modeMultiplier = (mode == TVM_BEGIN) ? (1.0 + 0.1) : 1.0; /* Will adjust */
+static double tvm_iy_value(const IYProblem *p, double rate) {
+  double f, df, d2f;
+  tvm_iy_eval(p, rate, &f, &df, &d2f);
+  return f;
+}
 
-  /* Special case: if all zeros */
-  if (pv == 0.0 && pmt == 0.0 && fv == 0.0) {
-    *errorCode = ERR_INVALID_INPUT;
-    return 0.0;
+/*
+ * Closed-form starting rate.
+ *
+ * Level-payment loan (FV = 0): Feldman's approximation
+ *   i = ((1 + c)^(1/q) - 1)^q - 1,  c = -PMT/PV,  q = log2(1 + 1/n)
+ * is within a few parts in 10^4 for mortgage-like terms. BGN mode is the
+ * same loan with the first payment taken off PV and one period fewer.
+ *
+ * Otherwise (balloons, bonds): the yield approximation
+ *   i = (PMT + (FV + PV) / n) / ((FV - PV) / 2)
+ */
+static double tvm_iy_seed(const IYProblem *p) {
+  double n = p->n, pv = p->pv, pmt = p->pmt;
+  double seed = INITIAL_GUESS;
+
+  if (p->begin) {
+    pv += pmt;
+    n -= 1.0;
   }
 
-  /* Special case: no PMT, simple compound interest */
-  if (pmt == 0.0 && pv != 0.0 && fv != 0.0 && n > 0.0) {
-    double ratio = -fv / pv;
-    if (ratio > 0.0) {
-      *errorCode = ERR_NONE;
-      return pow(ratio, 1.0 / n) - 1.0;
-    }
+  double c = (pv != 0.0) ? -pmt / pv : 0.0;
+  if (p->fv == 0.0 && n >= 1.0 && c * n > 1.0) {
+    double q = log1p(1.0 / n) / log(2.0);
+    double x = fin_powm1(c, 1.0 / q);
+    seed = fin_powm1(x - 1.0, q);
+  } else if (p->fv != p->pv && p->n > 0.0) {
+    seed = (p->pmt + (p->fv + p->pv) / p->n) / ((p->fv - p->pv) / 2.0);
   }
 
-  /* Initial guess - use better heuristics */
-  double rate = INITIAL_GUESS;
+  if (!(seed > IY_MIN && seed < IY_MAX))
+    seed = INITIAL_GUESS;
+  return seed;
+}
 
-  /* Try to get a better initial guess based on sign of cash flows */
-  if (pv != 0.0 && fv != 0.0) {
-    double ratio = -fv / pv;
-    if (ratio > 0.0 && n > 0.0) {
-      rate = pow(ratio, 1.0 / n) - 1.0;
-      if (rate <= 0.0 || rate > 1.0)
-        rate = INITIAL_GUESS;
+/*
+ * Brent's method on a bracket [a, b] with f(a), f(b) of opposite signs:
+ * inverse quadratic interpolation or secant steps, with bisection
+ * whenever those would not shrink the bracket fast enough.
+ */
+static double tvm_iy_brent(const IYProblem *p, double a, double fa, double b,
+                           double fb, int budget, int *evaluations,
+                           int *errorCode) {
+  double c = a, fc = fa;
+  double d = b - a, e = d;
+
+  for (int iter = 0; iter < budget; iter++) {
+    if ((fb > 0) == (fc > 0)) {
+      c = a;
+      fc = fa;
+      d = e = b - a;
+    }
+    if (fabs(fc) < fabs(fb)) {
+      a = b;
+      b = c;
+      c = a;
+      fa = fb;
+      fb = fc;
+      fc = fa;
     }
-  }
 
-  /* Newton-Raphson iteration with optimized function evaluation */
-  double f, df;
-  
-  for (int iter = 0; iter < MAX_ITERATIONS; iter++) {
-    /* Update mode multiplier for current rate */
-    modeMultiplier = (mode == TVM_BEGIN) ? (1.0 + rate) : 1.0;
-    
-    /* Compute function and derivative in one call (optimized) */
-    tvm_function_and_derivative(rate, n, pv, pmt, fv, modeMultiplier, &f, &df);
-
-    /* Check for convergence */
-    if (fabs(f) < TOLERANCE) {
+    double tol = 2.0 * DBL_EPSILON * fabs(b) + 0.5 * TOLERANCE;
+    double m = 0.5 * (c - b);
+    if (fabs(m) <= tol || fb == 0.0) {
       *errorCode = ERR_NONE;
-      return rate;
+      return b;
     }
 
-    if (fabs(df) < 1e-15) {
-      /* Derivative too small, stuck */
-      break;
+    if (fabs(e) >= tol && fabs(fa) > fabs(fb)) {
+      double s = fb / fa, pq, q;
+      if (a == c) {
+        pq = 2.0 * m * s;
+        q = 1.0 - s;
+      } else {
+        double r = fb / fc, t = fa / fc;
+        pq = s * (2.0 * m * t * (t - r) - (b - a) * (r - 1.0));
+        q = (t - 1.0) * (r - 1.0) * (s - 1.0);
+      }
+      if (pq > 0)
+        q = -q;
+      else
+        pq = -pq;
+
+      if (2.0 * pq < fmin(3.0 * m * q - fabs(tol * q), fabs(e * q))) {
+        e = d;
+        d = pq / q;
+      } else {
+        d = m;
+        e = d;
+      }
+    } else {
+      d = m;
+      e = d;
     }
 
-    double newRate = rate - f / df;
+    a = b;
+    fa = fb;
+    b += (fabs(d) > tol) ? d : (m > 0 ? tol : -tol);
+    fb = tvm_iy_value(p, b);
+    (*evaluations)++;
+  }
 
-    /* Bound the rate to reasonable values */
-    if (newRate < -0.999)
-      newRate = -0.999;
-    if (newRate > 10.0)
-      newRate = 10.0;  /* 1000% max */
+  *errorCode = ERR_ITERATION;
+  return 0.0;
+}
 
-    /* Check for convergence */
-    if (fabs(newRate - rate) < TOLERANCE) {
-      *errorCode = ERR_NONE;
-      return newRate;
+/*
+ * Bracket a root starting from (*x, *fx): probe IY_EXPAND_STEP either
+ * side, doubling the distance each round, until the sign changes or
+ * both ends of the range are reached. Walking out from the current rate
+ * finds the nearest root even where the range ends have the same sign
+ * (FV and PV on the same side, with two rates that balance them).
+ * Non-finite values (overflow near -100%) carry no sign and are skipped.
+ */
+static int tvm_iy_expand(const IYProblem *p, double *a, double *fa,
+                         double *x, double *fx, int *evaluations) {
+  double lo = *x, hi = *x;
+  double fLo = *fx, fHi = *fx;
+  double step = IY_EXPAND_STEP;
+
+  while (lo > IY_MIN || hi < IY_MAX) {
+    for (int side = 0; side < 2; side++) {
+      double from = side ? lo : hi;
+      double fFrom = side ? fLo : fHi;
+      double to = side ? fmax(lo - step, IY_MIN) : fmin(hi + step, IY_MAX);
+      if (to == from)
+        continue;
+
+      double fTo = tvm_iy_value(p, to);
+      (*evaluations)++;
+
+      if (isfinite(fTo) && isfinite(fFrom) && (fTo > 0) != (fFrom > 0)) {
+        *a = from;
+        *fa = fFrom;
+        *x = to;
+        *fx = fTo;
+        return 1;
+      }
+
+      if (side) {
+        lo = to;
+        fLo = isfinite(fTo) ? fTo : fLo;
+      } else {
+        hi = to;
+        fHi = isfinite(fTo) ? fTo : fHi;
+      }
     }
+    step *= 2.0;
+  }
+
+  return 0;
+}
 
-    rate = newRate;
+double tvm_calc_iy_from(double n, double pv, double pmt, double fv,
+                        TVMMode mode, double guess, int *iterations,
+                        int *errorCode) {
+  IYProblem p = {n, pv, pmt, fv, mode == TVM_BEGIN};
+  int evaluations = 0;
+  double result = 0.0;
+
+  *errorCode = ERR_NONE;
+
+  if ((pv == 0.0 && pmt == 0.0 && fv == 0.0) || !(n > 0.0)) {
+    *errorCode = ERR_INVALID_INPUT;
+  } else if (pmt == 0.0 && pv != 0.0 && fv != 0.0 && -fv / pv > 0.0) {
+    /* No PMT: simple compound interest */
+    result = fin_powm1(-fv / pv - 1.0, 1.0 / n);
+  } else {
+    double rate = (guess > IY_MIN && guess < IY_MAX) ? guess
+                                                      : tvm_iy_seed(&p);
+    double prev = 0.0, fPrev = 0.0, lastStep = HUGE_VAL;
+    int havePrev = 0, solved = 0;
+
+    *errorCode = ERR_ITERATION;
+
+    for (int iter = 0; iter < MAX_ITERATIONS && !solved; iter++) {
+      double f, df, d2f;
+      tvm_iy_eval(&p, rate, &f, &df, &d2f);
+      evaluations++;
+
+      if (f == 0.0) {
+        result = rate;
+        *errorCode = ERR_NONE;
+        break;
+      }
+
+      /* A sign change since the last point brackets the root: hand over */
+      int bracketed = havePrev && isfinite(f) && (f > 0) != (fPrev > 0);
+
+      /* Halley: cubic convergence from the second derivative */
+      double denom = 2.0 * df * df - f * d2f;
+      double step = (denom != 0.0) ? -2.0 * f * df / denom : HUGE_VAL;
+      double next = rate + step;
+      int halley = isfinite(step) && next > IY_MIN && next < IY_MAX &&
+                   fabs(step) <= lastStep;
+
+      if (halley && bracketed)
+        halley = (next > fmin(prev, rate) && next < fmax(prev, rate));
+
+      if (halley) {
+        if (fabs(step) < TOLERANCE) {
+          result = next;
+          *errorCode = ERR_NONE;
+          break;
+        }
+        if (isfinite(f)) {
+          prev = rate;
+          fPrev = f;
+          havePrev = 1;
+        }
+        lastStep = fabs(step);
+        rate = next;
+        continue;
+      }
+
+      /* Halley misbehaved: bracket the root and let Brent finish */
+      double a = prev, fa = fPrev;
+      if (!bracketed && !tvm_iy_expand(&p, &a, &fa, &rate, &f, &evaluations)) {
+        *errorCode = ERR_NO_SOLUTION;
+        break;
+      }
+
+      result = tvm_iy_brent(&p, a, fa, rate, f, MAX_ITERATIONS, &evaluations,
+                            errorCode);
+      solved = 1;
+    }
+
+    if (*errorCode != ERR_NONE)
+      result = 0.0;
   }
 
-  /* Failed to converge */
-  *errorCode = ERR_ITERATION;
-  return 0.0;
+  if (iterations)
+    *iterations = evaluations;
+  return result;
+}
+
+double tvm_calc_iy(double n, double pv, double pmt, double fv, TVMMode mode,
+                   int *errorCode) {
+  return tvm_calc_iy_from(n, pv, pmt, fv, mode, IY_MIN, NULL, errorCode);
 }
 
 /* ============================================================
@@ -324,7 +748,7 @@ static double amort_balance_at(int period, double rate, double pv, double pmt) {
   if (rate == 0.0) {
     return pv + pmt * period;
   }
-  double compFactor = pow(1.0 + rate, period);
+  double compFactor = fin_powi(rate, period);
   return pv * compFactor + pmt * (compFactor - 1.0) / rate;
 }
 
@@ -340,9 +764,9 @@ AmortResult tvm_amort_period(int period, double n, double rate, double pv,
   double balanceStart = amort_balance_at(period - 1, rate, pv, pmt);
   
   /* This period's amortization */
-  result.interest = balanceStart * rate;
+  result.interest = -balanceStart * rate;
   result.principal = pmt - result.interest;
-  result.balance = balanceStart - result.principal;
+  result.balance = balanceStart + result.principal;
 
   return result;
 }
@@ -371,3 +795,119 @@ void tvm_amort_range(int startPeriod, int endPeriod, double n, double rate,
   /* Total interest = total payments - total principal paid */
   *totalInterest = totalPayments - *totalPrincipal;
 }
+
+/*
+ * Schedule generation: B(p) = B(p-1) * (1+i) + PMT is one multiply-add per
+ * row. Rounding error in the carried balance grows with (1+i)^k, so the
+ * balance is re-anchored to amort_balance_at every TVM_AMORT_RESYNC rows;
+ * the drift between anchors stays far below display precision.
+ */
+#define TVM_AMORT_RESYNC 64
+
+int tvm_amort_schedule(int startPeriod, int endPeriod, double rate, double pv,
+                       double pmt, AmortResult rows[], int maxRows,
+                       AmortSink sink, void *context) {
+  if (startPeriod < 1)
+    startPeriod = 1;
+  if (!rows && !sink)
+    return 0;
+  if (rows && maxRows < endPeriod - startPeriod + 1)
+    endPeriod = startPeriod + maxRows - 1;
+
+  double growth = 1.0 + rate;
+  double balance = amort_balance_at(startPeriod - 1, rate, pv, pmt);
+  int count = 0;
+
+  for (int period = startPeriod; period <= endPeriod; period++) {
+    if (count > 0 && count % TVM_AMORT_RESYNC == 0)
+      balance = amort_balance_at(period - 1, rate, pv, pmt);
+
+    AmortResult row;
+    row.interest = -balance * rate;
+    row.principal = pmt - row.interest;
+    row.balance = balance * growth + pmt;
+    balance = row.balance;
+
+    if (rows)
+      rows[count] = row;
+    count++;
+
+    if (sink && sink(context, period, &row))
+      break;
+  }
+
+  return count;
+}
+
+/* ============================================================
+ * Rate x Term Grid
+ * ============================================================ */
+
+int tvm_grid_check(const TVMGrid *grid) {
+  if (grid->rateCount <= 0 || grid->termCount <= 0 || grid->balancePeriod < 0)
+    return ERR_INVALID_INPUT;
+
+  for (int r = 0; r < grid->rateCount; r++) {
+    if (!(grid->rates[r] > -1.0))
+      return ERR_INVALID_INPUT;
+  }
+  for (int t = 0; t < grid->termCount; t++) {
+    if (grid->terms[t] < 1 || (t > 0 && grid->terms[t] < grid->terms[t - 1]))
+      return ERR_INVALID_INPUT;
+  }
+
+  return ERR_NONE;
+}
+
+/*
+ * One column walks the terms with a running discount factor,
+ *   (1+i)^-t(k) = (1+i)^-t(k-1) * (1+i)^-(t(k) - t(k-1)),
+ * recomputing the step factor only when the spacing changes. The
+ * balance after P payments needs (1+i)^P once per column; terms of P
+ * or fewer periods are paid down to the balloon, -FV.
+ */
+void tvm_grid_column(const TVMGrid *grid, int column, double pmt[],
+                     double balance[]) {
+  double rate = grid->rates[column];
+  int stride = grid->rateCount;
+  int period = grid->balancePeriod;
+  double discount = 1.0, step = 1.0;
+  int prevTerm = 0, spacing = 0;
+
+  double compound = (rate == 0.0 || !balance) ? 1.0 : fin_powi(rate, period);
+
+  for (int t = 0; t < grid->termCount; t++) {
+    int term = grid->terms[t];
+
+    if (rate != 0.0 && term != prevTerm) {
+      if (term - prevTerm != spacing) {
+        spacing = term - prevTerm;
+        step = fin_powi(rate, -(double)spacing);
+      }
+      discount *= step;
+    }
+    prevTerm = term;
+
+    double payment = tvm_pmt_from(term, rate, discount, grid->pv, grid->fv,
+                                  grid->mode);
+    pmt[t * stride + column] = payment;
+
+    if (balance) {
+      balance[t * stride + column] =
+          (period >= term) ? -grid->fv
+                           : -tvm_fv_from(period, rate, compound, grid->pv,
+                                          payment, grid->mode);
+    }
+  }
+}
+
+int tvm_grid(const TVMGrid *grid, double pmt[], double balance[]) {
+  int errorCode = tvm_grid_check(grid);
+  if (errorCode != ERR_NONE)
+    return errorCode;
+
+  for (int r = 0; r < grid->rateCount; r++)
+    tvm_grid_column(grid, r, pmt, balance);
+
+  return ERR_NONE;
+}
@@ -22,6 +22,27 @@
  */
 double tvm_solve_for(Calculator *calc, TVMVariable solveFor);
 
+/**
+ * Solve one TVM variable for many deals stored as parallel arrays
+ * (structure-of-arrays loan tape). No Calculator is built per deal.
+ *
+ * Inputs use the same units as TVM_Data (I/Y in annual %, P/Y, C/Y).
+ * The array for the variable being solved is ignored (may be NULL).
+ * PV/FV/PMT/N use the closed forms in branch-free chunked loops the
+ * compiler can vectorize; I/Y falls back to tvm_calc_iy per deal and
+ * is returned in annual % like tvm_solve_for.
+ *
+ * @param solveFor Which variable to solve for
+ * @param out Output: solved value per deal
+ * @param err Output: ERR_* code per deal
+ * @param count Number of deals
+ * @return Number of deals solved without error
+ */
+int tvm_solve_batch(TVMVariable solveFor, const double n[], const double iy[],
+                    const double pv[], const double pmt[], const double fv[],
+                    const double py[], const double cy[], const TVMMode mode[],
+                    double out[], int err[], int count);
+
 /* ============================================================
  * Individual TVM Functions
  * ============================================================ */
@@ -51,14 +72,38 @@ double tvm_calc_pmt(double n, double rate, double pv, double fv, TVMMode mode);
 double tvm_calc_n(double rate, double pv, double pmt, double fv, TVMMode mode);
 
 /**
- * Calculate Interest Rate (using Newton-Raphson)
- * Given: N, PV, PMT, FV
+ * Calculate Interest Rate (periodic, decimal)
+ * Given: N, PV, PMT, FV. Same as tvm_calc_iy_from with the closed-form
+ * starting rate.
  *
  * @param errorCode Output: Set to non-zero if no solution found
  */
 double tvm_calc_iy(double n, double pv, double pmt, double fv, TVMMode mode,
                    int *errorCode);
 
+/**
+ * Calculate Interest Rate, reporting the work done.
+ *
+ * Halley steps from the starting rate while they stay inside
+ * (-99.9%, 1000%) and do not grow; otherwise the root is bracketed (from
+ * the last sign change, or by probing outward from the current rate) and
+ * Brent's method finishes. Mortgage-like inputs converge in 2-3
+ * evaluations. Where two rates balance the flows, the nearer one to the
+ * starting rate is returned.
+ *
+ * @param guess Starting periodic rate; outside (-99.9%, 1000%) (e.g. -1)
+ *              uses a closed-form estimate (Feldman's approximation for
+ *              level-payment loans, the yield approximation otherwise)
+ * @param iterations Output: TVM equation evaluations used (may be NULL)
+ * @param errorCode Output: ERR_INVALID_INPUT, ERR_NO_SOLUTION if no sign
+ *                  change is found in the range, ERR_ITERATION if the
+ *                  solve did not converge
+ * @return Periodic rate as decimal
+ */
+double tvm_calc_iy_from(double n, double pv, double pmt, double fv,
+                        TVMMode mode, double guess, int *iterations,
+                        int *errorCode);
+
 /* ============================================================
  * Amortization
  * ============================================================ */
@@ -75,11 +120,15 @@ typedef struct {
 /**
  * Calculate amortization for a specific period.
  *
+ * Signs follow the TVM cash-flow convention: for a loan PV is positive and
+ * PMT negative, so interest and principal come out negative and the
+ * balance is B(p) = B(p-1) * (1 + rate) + pmt.
+ *
  * @param period Period number (1-based)
  * @param n Total number of periods
  * @param rate Periodic interest rate (not annual %)
- * @param pv Loan amount (positive)
- * @param pmt Payment amount (positive)
+ * @param pv Loan amount
+ * @param pmt Payment amount (opposite sign to pv)
  * @return Amortization breakdown for this period
  */
 AmortResult tvm_amort_period(int period, double n, double rate, double pv,
@@ -99,6 +148,100 @@ void tvm_amort_range(int startPeriod, int endPeriod, double n, double rate,
                      double pv, double pmt, double *totalPrincipal,
                      double *totalInterest, double *endBalance);
 
+/**
+ * Row sink for tvm_amort_schedule.
+ *
+ * @param context Caller data passed through unchanged
+ * @param period Period number of this row (1-based)
+ * @param row Amortization breakdown for the period
+ * @return 0 to continue, non-zero to stop the schedule early
+ */
+typedef int (*AmortSink)(void *context, int period, const AmortResult *row);
+
+/**
+ * Generate amortization rows for periods startPeriod..endPeriod.
+ *
+ * The balance is carried forward with one multiply-add per row and
+ * re-anchored to the closed form every TVM_AMORT_RESYNC rows, so a
+ * 360-row schedule costs a handful of pow() calls instead of one per row.
+ * Rows match tvm_amort_period.
+ *
+ * Rows go to the caller's buffer, the sink, or both. With rows == NULL
+ * and a sink, schedules of any length stream through without being
+ * stored; a long schedule can also be produced in windows by advancing
+ * startPeriod.
+ *
+ * @param startPeriod First period (1-based)
+ * @param endPeriod Last period (inclusive)
+ * @param rate Periodic interest rate (not annual %)
+ * @param pv Loan amount
+ * @param pmt Payment amount (opposite sign to pv)
+ * @param rows Output: rows[k] is period startPeriod + k (may be NULL)
+ * @param maxRows Capacity of rows; generation stops when it is full
+ * @param sink Called once per row (may be NULL)
+ * @param context Passed to sink
+ * @return Number of rows generated
+ */
+int tvm_amort_schedule(int startPeriod, int endPeriod, double rate, double pv,
+                       double pmt, AmortResult rows[], int maxRows,
+                       AmortSink sink, void *context);
+
+/* ============================================================
+ * Rate x Term Grid
+ * ============================================================ */
+
+/**
+ * One loan priced over a set of rates and terms (a rate sheet). Outputs
+ * are row-major with one row per term and one column per rate: the cell
+ * for terms[t] and rates[r] is out[t * rateCount + r].
+ */
+typedef struct {
+  const double *rates; /* Periodic rates (decimal, > -1), one per column */
+  int rateCount;
+  const int *terms;    /* Terms in periods, ascending, one per row */
+  int termCount;
+  double pv;           /* Loan amount */
+  double fv;           /* Balloon (0 for a fully amortizing loan) */
+  TVMMode mode;        /* END or BEGIN */
+  int balancePeriod;   /* Balance reported after this many payments */
+} TVMGrid;
+
+/**
+ * Check a grid before it is filled a column at a time.
+ *
+ * @return ERR_NONE, or ERR_INVALID_INPUT for an empty grid, a rate at or
+ *         below -100%, a term below 1, terms out of order or a negative
+ *         balancePeriod
+ */
+int tvm_grid_check(const TVMGrid *grid);
+
+/**
+ * Fill one rate column of a checked grid.
+ *
+ * The terms are walked with a running product of (1+i), so evenly
+ * spaced terms cost one power for the whole column (two with balances)
+ * instead of one per cell. Cells match tvm_calc_pmt and the
+ * amortization balance to within rounding. Columns are independent and
+ * may be filled from different threads.
+ *
+ * @param column Index into grid->rates
+ * @param pmt Output: payment per period, row-major (see TVMGrid)
+ * @param balance Output: remaining balance after balancePeriod payments,
+ *                row-major; -FV where the term is no longer than that
+ *                (may be NULL)
+ */
+void tvm_grid_column(const TVMGrid *grid, int column, double pmt[],
+                     double balance[]);
+
+/**
+ * Fill a whole grid, column by column.
+ *
+ * @param pmt Output: rateCount * termCount payments, row-major
+ * @param balance Output: same layout for balances (may be NULL)
+ * @return ERR_NONE, or the tvm_grid_check error (nothing written)
+ */
+int tvm_grid(const TVMGrid *grid, double pmt[], double balance[]);
+
 /* ============================================================
  * Helper Functions
  * ============================================================ */
@@ -10,6 +10,7 @@
 
 /* Forward declaration */
 #include "memory.h"
+#include "statistics.h"
 
 /* ============================================================
  * Calculator Model (Standard vs Professional)
@@ -55,34 +56,65 @@ typedef enum {
 /* ============================================================
  * TVM Data Structure
  * ============================================================ */
+
+/*
+ * Periodic rate and compound factor for the I/Y, P/Y, C/Y and N they
+ * were computed from, so solving PV, FV and PMT in turn on one deal
+ * costs one power. Checked against the live fields on every use;
+ * tvm_store also clears it when N or I/Y change.
+ */
 typedef struct {
-  double N;     /* Number of periods */
-  double I_Y;   /* Interest rate per year (%) */
-  double PV;    /* Present Value */
-  double PMT;   /* Payment per period */
-  double FV;    /* Future Value */
-  double P_Y;   /* Payments per year */
-  double C_Y;   /* Compounding periods per year */
-  TVMMode mode; /* END or BEGIN */
-} TVM_Data;
+  int valid;       /* rate/compound match the key below */
+  double I_Y;      /* Key: I/Y, P/Y, C/Y the rate was computed from */
+  double P_Y;
+  double C_Y;
+  double N;        /* Key: N the compound factor was computed for */
+  double rate;     /* Periodic rate */
+  double compound; /* (1 + rate)^N */
+  double discount; /* (1 + rate)^-N */
+} TVMCache;
 
-/* ============================================================
- * Cash Flow Item (for NPV/IRR calculations)
- * ============================================================ */
 typedef struct {
-  double amount; /* Cash flow amount */
-  int frequency; /* Number of times this flow repeats (F01, F02, etc.) */
-} CashFlowItem;
+  double N;       /* Number of periods */
+  double I_Y;     /* Interest rate per year (%) */
+  double PV;      /* Present Value */
+  double PMT;     /* Payment per period */
+  double FV;      /* Future Value */
+  double P_Y;     /* Payments per year */
+  double C_Y;     /* Compounding periods per year */
+  TVMMode mode;   /* END or BEGIN */
+  TVMCache cache; /* Maintained by tvm.c */
+} TVM_Data;
 
 /* ============================================================
  * Cash Flow List
+ * Groups are stored as parallel arrays (structure of arrays); larger
+ * lists live in an arena-backed CashFlowSeries (cashflow.h).
  * ============================================================ */
 #define MAX_CASH_FLOWS 32
 
+/*
+ * Discounting state at the last rate cf_npv was asked for, kept current
+ * by cf_set_cf0/cf_add/cf_update so a one-flow edit re-prices in O(1).
+ * Flows must be edited through those functions for the cache to hold.
+ */
 typedef struct {
-  double CF0;                         /* Initial cash flow (usually negative) */
-  CashFlowItem flows[MAX_CASH_FLOWS]; /* Subsequent cash flows */
-  int count;                          /* Number of cash flow groups */
+  int valid;                        /* npv/unitValue match the flows */
+  int edits;                        /* O(1) NPV updates since the last re-sum */
+  double rate;                      /* Rate the cache was built at */
+  double npv;                       /* NPV at rate */
+  double unitValue[MAX_CASH_FLOWS]; /* PV at rate of 1 per period of group j */
+  double endDiscount;               /* Discount across every group, v^n */
+  int hasIrr;                       /* irr holds a converged root */
+  double irr;                       /* Last IRR, warm start for the next */
+} CashFlowCache;
+
+typedef struct {
+  double CF0;                     /* Initial cash flow (usually negative) */
+  double amount[MAX_CASH_FLOWS];  /* Cj: amount of group j */
+  int frequency[MAX_CASH_FLOWS];  /* Fj: times group j repeats */
+  int count;                      /* Number of cash flow groups */
+  CashFlowCache cache;            /* Maintained by cashflow.c */
 } CashFlowList;
 
 /* ============================================================
@@ -106,6 +138,8 @@ typedef struct {
   double accruedInterest;
   double duration;
   double modDuration;
+  int hasResult;             /* Outputs above hold a cached solve */
+  uint32_t resultGeneration; /* wsGeneration of that solve */
 } BondData;
 
 /* Depreciation worksheet data */
@@ -117,6 +151,10 @@ typedef struct {
   int startMonth;  /* 1-12 */
   int method;      /* 0=SL, 1=SYD, 2=DB, 3=DB-SL, 4=SLF, 5=DBF */
   int currentYear; /* Year being viewed */
+  int hasResult;             /* Cached outputs below are filled */
+  uint32_t resultGeneration; /* wsGeneration of the cached outputs */
+  double depreciation;       /* Cached DEP for currentYear */
+  double bookValue;          /* Cached RBV for currentYear */
 } DeprData;
 
 /* Date worksheet data */
@@ -133,7 +171,9 @@ typedef struct {
   double yData[50];
   int hasY[50];
   int count;
-  int regType; /* 0=LIN, 1=LOG, 2=EXP, 3=PWR */
+  int regType;            /* 0=LIN, 1=LOG, 2=EXP, 3=PWR */
+  StatAccumulator oneVar; /* Every x (y = 0) */
+  StatAccumulator twoVar; /* Points with a y entered */
 } StatDataSimple;
 
 /* Breakeven analysis data */
@@ -211,6 +251,9 @@ typedef struct {
   /* Current worksheet variable index (for up/down navigation) */
   int worksheetIndex;
 
+  /* Bumped on every worksheet input write; keys the output caches */
+  uint32_t wsGeneration;
+
   /* Basic arithmetic state */
   double accumulator;
   char pendingOp;      /* '+', '-', '*', '/', or 0 */
@@ -55,13 +55,15 @@ static int ws_bond_calculate(Calculator *calc, BondResult *result) {
   input.bondType =
       (calc->bond.bondType == BOND_TYPE_YTC) ? BOND_TYPE_YTC : BOND_TYPE_YTM;
 
-  *result = bond_calculate(&input, calc->bond.price, calc->bond.yield);
+  *result = bond_calculate(&input, calc->bond.price, calc->bond.yield, NULL);
 
   calc->bond.price = result->price;
   calc->bond.yield = result->yield;
   calc->bond.accruedInterest = result->accruedInterest;
   calc->bond.duration = result->duration;
   calc->bond.modDuration = result->modDuration;
+  calc->bond.hasResult = 1;
+  calc->bond.resultGeneration = calc->wsGeneration;
 
   return 1;
 }
@@ -86,22 +88,37 @@ static int ws_depr_calculate(Calculator *calc, DepreciationResult *result) {
   return 1;
 }
 
-static void ws_stats_build(const StatDataSimple *simple, StatData *oneVar,
-                           StatData *twoVar) {
-  stat_init(oneVar);
-  stat_init(twoVar);
+/*
+ * Output caches. Every input write goes through ws_set_value (or a
+ * calc_reset_*), which bumps calc->wsGeneration; cached outputs are
+ * reused while their generation still matches, so redraws and scrolling
+ * through output rows never re-solve unchanged inputs.
+ */
+static int ws_cache_fresh(const Calculator *calc, int hasResult,
+                          uint32_t resultGeneration) {
+  return hasResult && resultGeneration == calc->wsGeneration;
+}
 
-  for (int i = 0; i < simple->count && i < STAT_MAX_POINTS; i++) {
-    stat_add_x(oneVar, simple->xData[i]);
-    if (simple->hasY[i]) {
-      stat_add_xy(twoVar, simple->xData[i], simple->yData[i]);
-    }
+static void ws_bond_outputs(Calculator *calc) {
+  if (!ws_cache_fresh(calc, calc->bond.hasResult,
+                      calc->bond.resultGeneration)) {
+    BondResult result;
+    ws_bond_calculate(calc, &result);
   }
+}
 
-  twoVar->regType = (simple->regType >= REG_LINEAR &&
-                     simple->regType <= REG_POWER)
-                        ? (RegressionType)simple->regType
-                        : REG_LINEAR;
+static void ws_depr_outputs(Calculator *calc) {
+  DeprData *depr = &calc->depreciation;
+  if (ws_cache_fresh(calc, depr->hasResult, depr->resultGeneration))
+    return;
+
+  DepreciationResult result = {0};
+  int hasDepr = ws_depr_calculate(calc, &result);
+
+  depr->depreciation = hasDepr ? result.depreciation : 0.0;
+  depr->bookValue = hasDepr ? result.bookValueEnd : 0.0;
+  depr->hasResult = 1;
+  depr->resultGeneration = calc->wsGeneration;
 }
 
 /* ============================================================
@@ -300,18 +317,17 @@ double ws_get_value(WorksheetState *ws, Calculator *calc) {
     int isFreq = (ws->currentIndex - 1) % 2;
     if (cfIdx < calc->cashflow.count) {
       if (isFreq) {
-        return (double)calc->cashflow.flows[cfIdx].frequency;
+        return (double)calc->cashflow.frequency[cfIdx];
       } else {
-        return calc->cashflow.flows[cfIdx].amount;
+        return calc->cashflow.amount[cfIdx];
       }
     }
     break;
   }
   case WS_BOND: {
-    BondResult bondResult = {0};
-    int computed = 0;
+    /* Outputs are solved once per input generation */
     if (ws->currentIndex >= 8) {
-      computed = ws_bond_calculate(calc, &bondResult);
+      ws_bond_outputs(calc);
     }
 
     switch (ws->currentIndex) {
@@ -332,20 +348,21 @@ double ws_get_value(WorksheetState *ws, Calculator *calc) {
     case 7:
       return (double)calc->bond.dayCount;
     case 8:
-      return computed ? bondResult.yield : calc->bond.yield;
+      return calc->bond.yield;
     case 9:
-      return computed ? bondResult.price : calc->bond.price;
+      return calc->bond.price;
     case 10:
-      return computed ? bondResult.accruedInterest : calc->bond.accruedInterest;
+      return calc->bond.accruedInterest;
     case 11:
-      return computed ? bondResult.duration : calc->bond.duration;
+      return calc->bond.duration;
     }
     break;
   }
   case WS_DEPRECIATION: {
     /* Depreciation: LIF, MON, CST, SAL, YR, DEP, RBV */
-    DepreciationResult deprResult = {0};
-    int hasDepr = ws_depr_calculate(calc, &deprResult);
+    if (ws->currentIndex >= 5) {
+      ws_depr_outputs(calc);
+    }
     switch (ws->currentIndex) {
     case 0:
       return calc->depreciation.life;
@@ -358,9 +375,9 @@ double ws_get_value(WorksheetState *ws, Calculator *calc) {
     case 4:
       return (double)calc->depreciation.currentYear;
     case 5:
-      return hasDepr ? deprResult.depreciation : 0.0;
+      return calc->depreciation.depreciation;
     case 6:
-      return hasDepr ? deprResult.bookValueEnd : 0.0;
+      return calc->depreciation.bookValue;
     }
     break;
   }
@@ -377,14 +394,14 @@ double ws_get_value(WorksheetState *ws, Calculator *calc) {
     break;
   }
   case WS_STATISTICS: {
-    StatData oneVar, twoVar;
-    ws_stats_build(&calc->statistics, &oneVar, &twoVar);
-    Stat1VarResult oneRes = stat_calc_1var(&oneVar);
-    Stat2VarResult twoRes = stat_calc_2var(&twoVar);
-    RegressionResult reg = stat_regression(
-        &twoVar,
-        (twoVar.regType >= REG_LINEAR && twoVar.regType <= REG_POWER)
-            ? twoVar.regType
+    /* Accumulators are kept current by ws_set_value: O(1) reads */
+    const StatDataSimple *stats = &calc->statistics;
+    Stat1VarResult oneRes = stat_acc_1var(&stats->oneVar);
+    Stat2VarResult twoRes = stat_acc_2var(&stats->twoVar);
+    RegressionResult reg = stat_acc_regression(
+        &stats->twoVar,
+        (stats->regType >= REG_LINEAR && stats->regType <= REG_POWER)
+            ? (RegressionType)stats->regType
             : REG_LINEAR);
 
     switch (ws->currentIndex) {
@@ -424,6 +441,9 @@ double ws_get_value(WorksheetState *ws, Calculator *calc) {
 }
 
 void ws_set_value(WorksheetState *ws, Calculator *calc, double value) {
+  /* Any input write invalidates the cached worksheet outputs */
+  calc->wsGeneration++;
+
   switch (ws->type) {
   case WS_TVM: {
     switch (ws->currentIndex) {
@@ -447,7 +467,7 @@ void ws_set_value(WorksheetState *ws, Calculator *calc, double value) {
   }
   case WS_CASH_FLOW: {
     if (ws->currentIndex == 0) {
-      calc->cashflow.CF0 = value;
+      cf_set_cf0(&calc->cashflow, value);
     }
     break;
   }
@@ -524,18 +544,26 @@ void ws_set_value(WorksheetState *ws, Calculator *calc, double value) {
     break;
   }
   case WS_STATISTICS: {
+    StatDataSimple *stats = &calc->statistics;
     if (ws->currentIndex == 0) {
-      if (calc->statistics.count >= 50)
+      if (stats->count >= 50)
         break;
-      calc->statistics.xData[calc->statistics.count] = value;
-      calc->statistics.yData[calc->statistics.count] = 0.0;
-      calc->statistics.hasY[calc->statistics.count] = 0;
-      calc->statistics.count++;
+      stats->xData[stats->count] = value;
+      stats->yData[stats->count] = 0.0;
+      stats->hasY[stats->count] = 0;
+      stats->count++;
+      stat_acc_add(&stats->oneVar, value, 0.0);
     } else if (ws->currentIndex == 1) {
-      if (calc->statistics.count == 0)
+      if (stats->count == 0)
         break;
-      calc->statistics.yData[calc->statistics.count - 1] = value;
-      calc->statistics.hasY[calc->statistics.count - 1] = 1;
+      int last = stats->count - 1;
+      /* Re-entering Y replaces this point's previous pair */
+      if (stats->hasY[last])
+        stat_acc_remove(&stats->twoVar, stats->xData[last],
+                        stats->yData[last]);
+      stats->yData[last] = value;
+      stats->hasY[last] = 1;
+      stat_acc_add(&stats->twoVar, stats->xData[last], value);
     }
     break;
   }
@@ -0,0 +1,365 @@
+/**
+ * Open fx-BA: TI BA II Plus Clone
+ * xcashflow.c - Dated cash flows (XNPV, XIRR)
+ */
+
+#include "xcashflow.h"
+#include "config.h"
+#include "date.h"
+#include <math.h>
+
+#define XCF_IRR_MIN -0.999 /* Same search range as cf_irr */
+#define XCF_IRR_MAX 10.0
+#define XCF_SCAN_STEPS 64   /* Cells of the multiple-root scan */
+#define XCF_GRID_SCALE 0.1  /* Grid stretch, see xcf_grid_t */
+#define XCF_STALL 0.9       /* Newton step/last step that counts as stalled */
+
+/* ============================================================
+ * Loading
+ * ============================================================ */
+
+static int xcf_date_valid(int yyyymmdd) {
+  Date d = {yyyymmdd / 10000, (yyyymmdd / 100) % 100, yyyymmdd % 100};
+  return date_is_valid(&d);
+}
+
+static double xcf_days_in_calendar_year(int year) {
+  return date_is_leap_year(year) ? 366.0 : 365.0;
+}
+
+/* Day of the year counted from 0 (January 1) */
+static double xcf_day_of_year(int yyyymmdd) {
+  int year = yyyymmdd / 10000;
+  return (double)(date_to_days(yyyymmdd) - date_days_from_civil(year, 1, 1));
+}
+
+static double xcf_year_fraction(int first, int date,
+                                DayCountConvention dayCount) {
+  if (dayCount == DAY_COUNT_ACT_ACT) {
+    /* ISDA: whole years between, plus each end's share of its own year */
+    int y1 = first / 10000, y2 = date / 10000;
+    return (double)(y2 - y1) +
+           xcf_day_of_year(date) / xcf_days_in_calendar_year(y2) -
+           xcf_day_of_year(first) / xcf_days_in_calendar_year(y1);
+  }
+
+  return (double)days_between(first, date, dayCount) /
+         (double)days_in_year(dayCount);
+}
+
+int xcf_load(DatedCashFlows *flows, const int dates[], const double amounts[],
+             double years[], int count, DayCountConvention dayCount) {
+  flows->amount = amounts;
+  flows->years = years;
+  flows->count = 0;
+  flows->firstDate = count > 0 ? dates[0] : 0;
+  flows->dayCount = dayCount;
+
+  if (count <= 0)
+    return ERR_INVALID_INPUT;
+
+  for (int i = 0; i < count; i++) {
+    if (!xcf_date_valid(dates[i]) || (i > 0 && dates[i] < dates[i - 1]))
+      return ERR_INVALID_INPUT;
+    years[i] = xcf_year_fraction(dates[0], dates[i], dayCount);
+  }
+
+  flows->count = count;
+  return ERR_NONE;
+}
+
+/* ============================================================
+ * XNPV
+ * ============================================================ */
+
+double xcf_npv(const DatedCashFlows *flows, double rate) {
+  double lnOnePlusRate = log1p(rate);
+  double npv = 0.0;
+
+  for (int i = 0; i < flows->count; i++)
+    npv += flows->amount[i] * exp(-flows->years[i] * lnOnePlusRate);
+
+  return npv;
+}
+
+/* XNPV and d(XNPV)/d(rate) from one exp per flow */
+static void xcf_npv_and_derivative(const DatedCashFlows *flows, double rate,
+                                   double *npv, double *derivative) {
+  double lnOnePlusRate = log1p(rate);
+  double value = 0.0, weighted = 0.0;
+
+  for (int i = 0; i < flows->count; i++) {
+    double term = flows->amount[i] * exp(-flows->years[i] * lnOnePlusRate);
+    value += term;
+    weighted += flows->years[i] * term;
+  }
+
+  *npv = value;
+  *derivative = -weighted / (1.0 + rate);
+}
+
+/*
+ * Discounted inflows and outflows kept apart, as in cf_irr: value[1]
+ * sums the positive flows, value[0] the magnitudes of the negative ones,
+ * and slope[] holds their derivatives in u = log(1+r).
+ */
+static void xcf_npv_split(const DatedCashFlows *flows, double rate,
+                          double value[2], double slope[2]) {
+  double lnOnePlusRate = log1p(rate);
+
+  value[0] = value[1] = 0.0;
+  slope[0] = slope[1] = 0.0;
+
+  for (int i = 0; i < flows->count; i++) {
+    double term =
+        fabs(flows->amount[i]) * exp(-flows->years[i] * lnOnePlusRate);
+    int in = flows->amount[i] > 0.0;
+    value[in] += term;
+    slope[in] -= flows->years[i] * term;
+  }
+}
+
+/* ============================================================
+ * XIRR
+ * ============================================================ */
+
+static int xcf_sign(double x) { return (x > 0) - (x < 0); }
+
+/* Sign changes along the flows in date order (zeros skipped) */
+static int xcf_sign_scan(const DatedCashFlows *flows, int *first,
+                         int *last) {
+  int changes = 0;
+  *first = *last = 0;
+
+  for (int i = 0; i < flows->count; i++) {
+    int s = xcf_sign(flows->amount[i]);
+    if (s == 0)
+      continue;
+    if (*first == 0)
+      *first = s;
+    else if (s != *last)
+      changes++;
+    *last = s;
+  }
+
+  return changes;
+}
+
+/*
+ * Same safeguards as cf_irr's bracketed solve: Newton anywhere inside the
+ * bracket unless it has stalled, else the secant through the ends, else
+ * bisection. A NaN XNPV (overflow near -100%) is treated as lying below
+ * the root.
+ */
+static double xcf_irr_bracketed(const DatedCashFlows *flows, double lo,
+                                double fLo, double hi, double fHi,
+                                double rate, int *evaluations,
+                                int *errorCode) {
+  double lastStep = hi - lo;
+
+  *errorCode = ERR_NONE;
+
+  for (int iter = 0; iter < MAX_ITERATIONS; iter++) {
+    double f, df;
+    xcf_npv_and_derivative(flows, rate, &f, &df);
+    (*evaluations)++;
+
+    if (fabs(f) < TOLERANCE)
+      return rate;
+
+    if (isnan(f) || xcf_sign(f) == xcf_sign(fLo)) {
+      lo = rate;
+      fLo = isnan(f) ? fLo : f;
+    } else {
+      hi = rate;
+      fHi = f;
+    }
+
+    double newRate = rate - f / df;
+    int newton = df != 0.0 && newRate > lo && newRate < hi &&
+                 fabs(newRate - rate) < XCF_STALL * lastStep;
+
+    if (!newton) {
+      double span = hi - lo;
+      newRate = 0.5 * (lo + hi);
+
+      double secant = lo - fLo * span / (fHi - fLo);
+      if (secant > lo + 0.05 * span && secant < hi - 0.05 * span)
+        newRate = secant;
+    }
+
+    if (fabs(newRate - rate) < TOLERANCE || hi - lo < TOLERANCE)
+      return newRate;
+
+    lastStep = fabs(newRate - rate);
+    rate = newRate;
+  }
+
+  *errorCode = ERR_ITERATION;
+  return 0.0;
+}
+
+/*
+ * One sign change, solved as cf_irr does: Newton in u = log(1+r) on
+ * log(inflows) - log(outflows), which is nearly a straight line. Steps
+ * inside the bracket are kept, each evaluation narrows the bracket, and
+ * a range limit is only evaluated if Newton heads past it.
+ */
+static double xcf_irr_conventional(const DatedCashFlows *flows, double guess,
+                                   int *evaluations, int *errorCode) {
+  double lo = log1p(XCF_IRR_MIN), hi = log1p(XCF_IRR_MAX);
+  int loChecked = 0, hiChecked = 0;
+  double u = log1p(guess);
+
+  *errorCode = ERR_NONE;
+
+  for (int iter = 0; iter < MAX_ITERATIONS; iter++) {
+    double value[2], slope[2];
+    double rate = expm1(u);
+    xcf_npv_split(flows, rate, value, slope);
+    (*evaluations)++;
+
+    if (fabs(value[1] - value[0]) < TOLERANCE)
+      return rate;
+
+    /* Out of range powers: overflow below 0%, underflow above */
+    double step = -log(value[1] / value[0]) /
+                  (slope[1] / value[1] - slope[0] / value[0]);
+    int above = isfinite(step) ? step > 0.0 : u < 0.0;
+    if (above)
+      lo = u;
+    else
+      hi = u;
+
+    double next = u + step;
+    if (!(next > lo && next < hi)) {
+      int *checked = above ? &hiChecked : &loChecked;
+      if (isfinite(step) && !*checked) {
+        *checked = 1;
+        double limit = xcf_npv(flows, expm1(above ? hi : lo));
+        (*evaluations)++;
+        if (xcf_sign(limit) == xcf_sign(value[1] - value[0])) {
+          *errorCode = ERR_NO_SOLUTION;
+          return 0.0;
+        }
+      }
+      next = 0.5 * (lo + hi);
+    }
+
+    if (fabs(next - u) < TOLERANCE || hi - lo < TOLERANCE)
+      return expm1(next);
+    u = next;
+  }
+
+  *errorCode = ERR_ITERATION;
+  return 0.0;
+}
+
+/*
+ * The scan grid is the one cf_irr uses: even in t, where log(1 + rate) =
+ * XCF_GRID_SCALE * sinh(t), so cells are about 1.5% wide around 0%.
+ */
+static double xcf_grid_t(double rate) {
+  return asinh(log1p(rate) / XCF_GRID_SCALE);
+}
+
+static double xcf_grid_rate(int k) {
+  if (k <= 0)
+    return XCF_IRR_MIN;
+  if (k >= XCF_SCAN_STEPS)
+    return XCF_IRR_MAX;
+
+  double tMin = xcf_grid_t(XCF_IRR_MIN), tMax = xcf_grid_t(XCF_IRR_MAX);
+  double t = tMin + (tMax - tMin) * (double)k / XCF_SCAN_STEPS;
+  return expm1(XCF_GRID_SCALE * sinh(t));
+}
+
+/*
+ * Several sign changes: step outward from the guess's grid cell, one
+ * cell on each side per round, and solve in the first cell whose ends
+ * straddle zero. Each grid point is evaluated at most once.
+ */
+static double xcf_irr_nearest(const DatedCashFlows *flows, double guess,
+                              int *evaluations, int *errorCode) {
+  double npvAt[XCF_SCAN_STEPS + 1], slopeAt[XCF_SCAN_STEPS + 1];
+  unsigned char known[XCF_SCAN_STEPS + 1] = {0};
+
+  double tMin = xcf_grid_t(XCF_IRR_MIN), tMax = xcf_grid_t(XCF_IRR_MAX);
+  int home = (int)((xcf_grid_t(guess) - tMin) / (tMax - tMin) *
+                   XCF_SCAN_STEPS);
+  if (home < 0)
+    home = 0;
+  if (home >= XCF_SCAN_STEPS)
+    home = XCF_SCAN_STEPS - 1;
+
+  for (int d = 0; d < XCF_SCAN_STEPS; d++) {
+    for (int side = 0; side < 2; side++) {
+      int cell = side ? home - d - 1 : home + d;
+      if (cell < 0 || cell >= XCF_SCAN_STEPS)
+        continue;
+
+      for (int k = cell; k <= cell + 1; k++) {
+        if (!known[k]) {
+          xcf_npv_and_derivative(flows, xcf_grid_rate(k), &npvAt[k],
+                                 &slopeAt[k]);
+          known[k] = 1;
+          (*evaluations)++;
+        }
+      }
+
+      double lo = xcf_grid_rate(cell), hi = xcf_grid_rate(cell + 1);
+      double fLo = npvAt[cell], fHi = npvAt[cell + 1];
+
+      if (!isfinite(fLo) || !isfinite(fHi) ||
+          xcf_sign(fLo) * xcf_sign(fHi) > 0)
+        continue;
+      if (fLo == 0.0)
+        return lo;
+      if (fHi == 0.0)
+        return hi;
+
+      /* A warm guess, else Newton from the end nearer zero */
+      int near = fabs(fLo) < fabs(fHi) ? cell : cell + 1;
+      double start = xcf_grid_rate(near) - npvAt[near] / slopeAt[near];
+      if (guess > lo && guess < hi)
+        start = guess;
+      else if (!(start > lo && start < hi))
+        start = 0.5 * (lo + hi);
+      return xcf_irr_bracketed(flows, lo, fLo, hi, fHi, start, evaluations,
+                               errorCode);
+    }
+  }
+
+  *errorCode = ERR_NO_SOLUTION;
+  return 0.0;
+}
+
+double xcf_irr(const DatedCashFlows *flows, double guess, int *iterations,
+               int *errorCode) {
+  int evaluations = 0;
+  double irr = 0.0;
+
+  *errorCode = ERR_NONE;
+
+  if (flows->count == 0) {
+    *errorCode = ERR_INVALID_INPUT;
+  } else {
+    int first, last;
+    int changes = xcf_sign_scan(flows, &first, &last);
+
+    if (!(guess > XCF_IRR_MIN && guess < XCF_IRR_MAX))
+      guess = INITIAL_GUESS;
+
+    if (changes == 0) {
+      *errorCode = ERR_NO_SOLUTION;
+    } else if (changes == 1) {
+      irr = xcf_irr_conventional(flows, guess, &evaluations, errorCode);
+    } else {
+      irr = xcf_irr_nearest(flows, guess, &evaluations, errorCode);
+    }
+  }
+
+  if (iterations)
+    *iterations = evaluations;
+  return irr;
+}
@@ -0,0 +1,82 @@
+/**
+ * Open fx-BA: TI BA II Plus Clone
+ * xcashflow.h - Dated cash flows (XNPV, XIRR)
+ *
+ * Flows on arbitrary dates instead of whole periods, as in spreadsheet
+ * XNPV/XIRR: each flow is discounted by (1 + rate)^t, where t is its
+ * year fraction from the first date under a bond day-count convention.
+ */
+
+#ifndef XCASHFLOW_H
+#define XCASHFLOW_H
+
+#include "bond.h"
+#include "types.h"
+
+/* ============================================================
+ * Dated Flow Set
+ * ============================================================ */
+
+/**
+ * Flows and their precomputed year fractions. The amounts are borrowed
+ * from the caller and the year fractions live in a caller buffer, so a
+ * set of any length costs no copies.
+ */
+typedef struct {
+  const double *amount;        /* Amount of flow i (borrowed) */
+  const double *years;         /* Year fraction of flow i from firstDate */
+  int count;                   /* Number of flows */
+  int firstDate;               /* YYYYMMDD of flow 0 */
+  DayCountConvention dayCount; /* Convention the fractions were taken in */
+} DatedCashFlows;
+
+/* ============================================================
+ * Loading
+ * ============================================================ */
+
+/**
+ * Set up a flow set from (date, amount) pairs, computing each year
+ * fraction once so the solvers only evaluate exp(-t * log(1 + rate)).
+ *
+ * ACT/ACT splits each span at calendar year ends (ISDA); the other
+ * conventions divide days_between by days_in_year.
+ *
+ * @param dates YYYYMMDD dates in non-decreasing order
+ * @param amounts Flow amounts; must outlive the flow set
+ * @param years Caller buffer of count doubles for the year fractions
+ * @return ERR_NONE, or ERR_INVALID_INPUT for an empty set, an invalid
+ *         date or dates out of order
+ */
+int xcf_load(DatedCashFlows *flows, const int dates[], const double amounts[],
+             double years[], int count, DayCountConvention dayCount);
+
+/* ============================================================
+ * XNPV / XIRR
+ * ============================================================ */
+
+/**
+ * Net present value at the first date
+ * @param rate Annual effective discount rate (decimal, > -1)
+ */
+double xcf_npv(const DatedCashFlows *flows, double rate);
+
+/**
+ * Annual rate at which XNPV is zero.
+ *
+ * Solved like cf_irr_from: with one sign change the root is unique in
+ * (-99.9%, 1000%) and is found by bracketed Newton steps on
+ * log(inflows / outflows); with more, the search walks outward from the
+ * guess and returns the nearest root. Pass the last root as the guess
+ * to warm-start a re-solve after an edit.
+ *
+ * @param guess Starting rate (decimal); ignored unless within the range
+ * @param iterations Output: XNPV evaluations used (may be NULL)
+ * @param errorCode Output: ERR_NO_SOLUTION if no root lies in the range,
+ *                  ERR_INVALID_INPUT for an empty set, ERR_ITERATION if
+ *                  the solve did not converge
+ * @return XIRR as decimal
+ */
+double xcf_irr(const DatedCashFlows *flows, double guess, int *iterations,
+               int *errorCode);
+
+#endif /* XCASHFLOW_H */